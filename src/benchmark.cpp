@@ -18,12 +18,16 @@
   along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <iostream>
 #include <istream>
+#include <sstream>
 #include <vector>
 
 #include "misc.h"
+#include "movegen.h"
 #include "position.h"
 #include "search.h"
 #include "thread.h"
@@ -79,6 +83,93 @@ const vector<string> Defaults = {
   "8/R7/2q5/8/6k1/8/1P5p/K6R w - - 0 124"  // Draw
 };
 
+/// move_to_san() converts a legal move to short algebraic notation, with
+/// minimal disambiguation and without check or mate suffixes. Only used to
+/// match the bm/am opcodes of EPD test suites, so there is no Chess960
+/// support and no attempt to be fast.
+
+string move_to_san(const Position& pos, Move m) {
+
+  if (type_of(m) == CASTLING)
+      return to_sq(m) > from_sq(m) ? "O-O" : "O-O-O";
+
+  string san;
+  Square from = from_sq(m), to = to_sq(m);
+  PieceType pt = type_of(pos.moved_piece(m));
+
+  if (pt != PAWN)
+  {
+      san = string(1, " PNBRQK"[pt]);
+
+      // Collect other pieces of the same type able to move to the same square
+      Bitboard others = 0;
+      for (const auto& other : MoveList<LEGAL>(pos))
+          if (   to_sq(other) == to && from_sq(other) != from
+              && type_of(pos.moved_piece(other)) == pt)
+              others |= from_sq(other);
+
+      if (others)
+      {
+          if (!(others & file_bb(from)))
+              san += char('a' + file_of(from));
+          else if (!(others & rank_bb(from)))
+              san += char('1' + rank_of(from));
+          else
+              san += UCI::square(from);
+      }
+  }
+  else if (pos.capture(m))
+      san = string(1, char('a' + file_of(from)));
+
+  if (pos.capture(m))
+      san += 'x';
+
+  san += UCI::square(to);
+
+  if (type_of(m) == PROMOTION)
+      san += string("=") + " PNBRQK"[promotion_type(m)];
+
+  return san;
+}
+
+
+/// san_to_move() returns the legal move matching a SAN string, or MOVE_NONE.
+/// Check, mate and annotation suffixes are ignored, as suites are not
+/// consistent about them.
+
+Move san_to_move(const Position& pos, string san) {
+
+  while (   !san.empty()
+         && (san.back() == '+' || san.back() == '#' || san.back() == '!' || san.back() == '?'))
+      san.pop_back();
+
+  for (const auto& m : MoveList<LEGAL>(pos))
+      if (san == move_to_san(pos, m))
+          return m;
+
+  return MOVE_NONE;
+}
+
+
+/// read_packed_file() slurps a file of fixed-size PackedPosition records
+/// into memory in a single read. Iterating the returned vector is the bulk
+/// ingestion fast path: no per-position line splitting or FEN parsing.
+
+bool read_packed_file(const string& fname, vector<PackedPosition>& packed) {
+
+  ifstream file(fname, ios::binary | ios::ate);
+
+  if (!file.is_open())
+      return false;
+
+  size_t bytes = size_t(file.tellg());
+  packed.resize(bytes / sizeof(PackedPosition));
+  file.seekg(0);
+  file.read((char*)packed.data(), packed.size() * sizeof(PackedPosition));
+
+  return bool(file);
+}
+
 } // namespace
 
 /// benchmark() runs a simple benchmark by letting Stockfish analyze a set
@@ -88,11 +179,14 @@ const vector<string> Defaults = {
 /// depth 13), an optional file name where to look for positions in FEN
 /// format (defaults are the positions defined above) and the type of the
 /// limit value: depth (default), time in millisecs or number of nodes.
+/// A file name ending in ".bin" is read as packed binary records instead,
+/// see the "packfile" command.
 
 void benchmark(const Position& current, istream& is) {
 
   string token;
   vector<string> fens;
+  vector<PackedPosition> packed;
   Search::LimitsType limits;
 
   // Assign default values to missing arguments
@@ -124,6 +218,16 @@ void benchmark(const Position& current, istream& is) {
   else if (fenFile == "current")
       fens.push_back(current.fen());
 
+  else if (   fenFile.size() > 4
+           && !fenFile.compare(fenFile.size() - 4, 4, ".bin"))
+  {
+      if (!read_packed_file(fenFile, packed))
+      {
+          cerr << "Unable to open file " << fenFile << endl;
+          return;
+      }
+  }
+
   else
   {
       string fen;
@@ -145,16 +249,22 @@ void benchmark(const Position& current, istream& is) {
   uint64_t nodes = 0;
   TimePoint elapsed = now();
   Position pos;
+  size_t total = fens.size() + packed.size();
 
-  for (size_t i = 0; i < fens.size(); ++i)
+  for (size_t i = 0; i < total; ++i)
   {
       StateListPtr states(new std::deque<StateInfo>(1));
-      pos.set(fens[i], Options["UCI_Chess960"], &states->back(), Threads.main());
 
-      cerr << "\nPosition: " << i + 1 << '/' << fens.size() << endl;
+      if (i < fens.size())
+          pos.set(fens[i], Options["UCI_Chess960"], &states->back(), Threads.main());
+      else
+          pos.set(packed[i - fens.size()], &states->back(), Threads.main());
+
+      uci_out_flush(); // Order the progress line after any queued output
+      cerr << "\nPosition: " << i + 1 << '/' << total << endl;
 
       if (limitType == "perft")
-          nodes += Search::perft(pos, limits.depth * ONE_PLY);
+          nodes += Search::perft_parallel(pos, limits.depth * ONE_PLY);
 
       else
       {
@@ -167,6 +277,10 @@ void benchmark(const Position& current, istream& is) {
 
   elapsed = now() - elapsed + 1; // Ensure positivity to avoid a 'divide by zero'
 
+  // Let the writer thread drain before the direct cerr summary, so queued
+  // lines (perft divide output, last info strings) cannot land inside it
+  uci_out_flush();
+
   dbg_print(); // Just before exiting
 
   cerr << "\n==========================="
@@ -174,3 +288,328 @@ void benchmark(const Position& current, istream& is) {
        << "\nNodes searched  : " << nodes
        << "\nNodes/second    : " << 1000 * nodes / elapsed << endl;
 }
+
+
+/// analyze_file() implements the "analyzefile" command: it streams a file of
+/// FEN positions through the running engine, searching each one with the
+/// configured number of threads and a fixed limit, and emits one
+/// machine-readable result line per position. Compared to forking one engine
+/// process per position this amortizes initialization and keeps the hash and
+/// history tables warm across positions. Usage:
+///
+///   analyzefile <file> [depth|movetime|nodes <limit>]   (default: depth 13)
+
+void analyze_file(istream& is) {
+
+  string token, fenFile, limitType, limit;
+  Search::LimitsType limits;
+
+  is >> fenFile;
+  limitType = (is >> token) ? token : "depth";
+  limit     = (is >> token) ? token : "13";
+
+  if (limitType == "movetime")
+      limits.movetime = stoi(limit);
+
+  else if (limitType == "nodes")
+      limits.nodes = stoi(limit);
+
+  else
+      limits.depth = stoi(limit);
+
+  ifstream file(fenFile);
+
+  if (!file.is_open())
+  {
+      cerr << "Unable to open file " << fenFile << endl;
+      return;
+  }
+
+  string fen;
+  Position pos;
+
+  while (getline(file, fen))
+  {
+      if (fen.empty())
+          continue;
+
+      StateListPtr states(new std::deque<StateInfo>(1));
+      pos.set(fen, Options["UCI_Chess960"], &states->back(), Threads.main());
+
+      limits.startTime = now();
+      Threads.start_thinking(pos, states, limits);
+      Threads.main()->wait_for_search_finished();
+
+      // A mated or stalemated position yields a single MOVE_NONE root move
+      const Search::RootMove& rm = Threads.main()->rootMoves[0];
+      bool noMove = rm.pv[0] == MOVE_NONE;
+
+      sync_cout << "result bestmove " << UCI::move(rm.pv[0], pos.is_chess960())
+                << " score " << UCI::value(noMove ? (pos.checkers() ? -VALUE_MATE
+                                                                    : VALUE_DRAW)
+                                                  : rm.score)
+                << " depth " << (noMove ? 0 : Threads.main()->completedDepth / ONE_PLY)
+                << " nodes " << Threads.nodes_searched()
+                << " fen "   << fen << sync_endl;
+  }
+}
+
+
+/// pack_file() implements the "packfile" command: it converts a file of FEN
+/// lines into the fixed 32 bytes per position binary format that "bench"
+/// reads back directly. Paying the FEN parsing cost once at conversion time
+/// makes iterating millions of positions afterwards almost free. Usage:
+///
+///   packfile <fen file> <bin file>
+
+void pack_file(istream& is) {
+
+  string inName, outName;
+
+  is >> inName >> outName;
+
+  ifstream in(inName);
+  ofstream out(outName, ios::binary);
+
+  if (!in.is_open() || !out)
+  {
+      cerr << "Unable to open file " << (in.is_open() ? outName : inName) << endl;
+      return;
+  }
+
+  string fen;
+  size_t count = 0;
+  Position pos;
+  PackedPosition packed;
+  StateInfo st;
+
+  while (getline(in, fen))
+      if (!fen.empty())
+      {
+          pos.set(fen, false, &st, Threads.main());
+          pos.pack(packed);
+          out.write((const char*)&packed, sizeof(packed));
+          ++count;
+      }
+
+  sync_cout << "info string Packed " << count << " positions to " << outName << sync_endl;
+}
+
+
+/// run_suite() implements the "suite" command, a built-in EPD test-suite
+/// runner: each position is searched with the full thread pool by iterative
+/// fixed-depth re-searches until the per-position time budget runs out, or
+/// until the move demanded by the bm/am opcodes has been stable for several
+/// iterations, which lets easy positions finish in milliseconds instead of
+/// burning their whole budget. Prints one result line per position and a
+/// summary with solved counts, time-to-solution percentiles and total NPS.
+/// Usage:
+///
+///   suite <epd file> [movetime per position in ms (default 1000)]
+
+void run_suite(istream& is) {
+
+  string token, fname, line;
+
+  is >> fname;
+  TimePoint budget = (is >> token) ? stoi(token) : 1000;
+
+  ifstream file(fname);
+
+  if (!file.is_open())
+  {
+      cerr << "Unable to open file " << fname << endl;
+      return;
+  }
+
+  int total = 0, solved = 0;
+  uint64_t nodes = 0;
+  vector<TimePoint> solveTimes;
+  TimePoint started = now();
+  Position pos;
+
+  while (getline(file, line))
+  {
+      // An EPD record is the first four FEN fields followed by ';' separated
+      // opcodes. We care about bm (best moves), am (avoid moves) and id.
+      istringstream ls(line);
+      string f1, f2, f3, f4;
+
+      if (!(ls >> f1 >> f2 >> f3 >> f4) || f1[0] == '#')
+          continue;
+
+      StateListPtr states(new std::deque<StateInfo>(1));
+      pos.set(f1 + " " + f2 + " " + f3 + " " + f4 + " 0 1", false,
+              &states->back(), Threads.main());
+
+      vector<Move> best, avoid;
+      string id, opcodes;
+
+      while (getline(ls, opcodes, ';'))
+      {
+          istringstream os(opcodes);
+          os >> token;
+
+          if (token == "bm" || token == "am")
+              for (bool am = (token == "am"); os >> token; )
+              {
+                  Move m = san_to_move(pos, token);
+                  if (m != MOVE_NONE)
+                      (am ? avoid : best).push_back(m);
+              }
+
+          else if (token == "id")
+          {
+              getline(os, id);
+              id.erase(remove(id.begin(), id.end(), '"'), id.end());
+              id.erase(0, id.find_first_not_of(' '));
+          }
+      }
+
+      if (best.empty() && avoid.empty())
+          continue;
+
+      ++total;
+      Search::clear(); // Each position starts from a cold hash and history
+
+      TimePoint posStart = now(), solvedAt = -1;
+      int held = 0;
+      uint64_t posNodes = 0;
+      Search::LimitsType limits;
+
+      for (int depth = 1; depth < 128 && now() - posStart < budget; ++depth)
+      {
+          limits.depth = depth;
+          limits.startTime = now();
+
+          Threads.start_thinking(pos, states, limits);
+          Threads.main()->wait_for_search_finished();
+          posNodes += Threads.nodes_searched();
+
+          Move m = Threads.main()->rootMoves[0].pv[0];
+          bool ok =  (best.empty()  || std::count(best.begin(),  best.end(),  m))
+                  && (avoid.empty() || !std::count(avoid.begin(), avoid.end(), m));
+
+          if (ok && !held++)
+              solvedAt = now() - posStart;
+          else if (!ok)
+              held = 0, solvedAt = -1;
+
+          // The demanded move has been the best one for four iterations in
+          // a row: count the position as solved and move on.
+          if (held >= 4)
+              break;
+      }
+
+      nodes += posNodes;
+
+      if (solvedAt >= 0)
+          ++solved, solveTimes.push_back(std::max(solvedAt, TimePoint(1)));
+
+      sync_cout << "suite " << (solvedAt >= 0 ? "solved " : "FAILED ")
+                << (id.empty() ? f1 : id) << " time "
+                << (solvedAt >= 0 ? solvedAt : now() - posStart)
+                << " nodes " << posNodes << sync_endl;
+  }
+
+  TimePoint elapsed = now() - started + 1;
+  sort(solveTimes.begin(), solveTimes.end());
+
+  auto percentile = [&](int p) {
+      return solveTimes.empty() ? TimePoint(0)
+                                : solveTimes[(solveTimes.size() - 1) * p / 100];
+  };
+
+  sync_cout << "suite summary: solved " << solved << "/" << total
+            << ", solve time p50 " << percentile(50)
+            << "ms p90 " << percentile(90)
+            << "ms max " << percentile(100)
+            << "ms, total time " << elapsed
+            << "ms, nodes " << nodes
+            << ", nps " << 1000 * nodes / elapsed << sync_endl;
+}
+
+
+/// run_sweep() implements the "sweep" command: it re-runs the default bench
+/// position set over a thread-count ladder (1, 2, 4, ...) and a hash-size
+/// ladder (16, 32, ... MB), repeating each cell several times, and reports
+/// median and standard deviation of NPS and time-to-depth per cell as CSV.
+/// Used for scaling regression tests of a deployment without fragile shell
+/// scripting around single bench runs. Usage:
+///
+///   sweep [max threads (default 4)] [max hash MB (default 16)]
+///         [repeats (default 3)] [depth (default 13)]
+
+void run_sweep(istream& is) {
+
+  string token;
+
+  size_t maxThreads = (is >> token) ? stoi(token) : 4;
+  int maxHash       = (is >> token) ? stoi(token) : 16;
+  int repeats       = (is >> token) ? stoi(token) : 3;
+  int depth         = (is >> token) ? stoi(token) : 13;
+
+  auto median = [](vector<double> v) {
+      sort(v.begin(), v.end());
+      return (v[(v.size() - 1) / 2] + v[v.size() / 2]) / 2;
+  };
+
+  auto stddev = [](const vector<double>& v) {
+      double mean = 0, var = 0;
+      for (double x : v)
+          mean += x / v.size();
+      for (double x : v)
+          var += (x - mean) * (x - mean) / v.size();
+      return std::sqrt(var);
+  };
+
+  sync_cout << "threads,hash_mb,repeats,nodes,median_nps,stddev_nps,"
+               "median_ms,stddev_ms" << sync_endl;
+
+  for (size_t threads = 1; threads <= maxThreads; threads *= 2)
+      for (int hash = 16; hash <= maxHash; hash *= 2)
+      {
+          Options["Threads"] = to_string(threads);
+          Options["Hash"]    = to_string(hash);
+
+          vector<double> nps, ms;
+          uint64_t nodes = 0;
+
+          for (int r = 0; r < repeats; ++r)
+          {
+              Search::clear(); // Start each repeat from a cold hash and history
+
+              nodes = 0;
+              TimePoint elapsed = now();
+              Position pos;
+
+              for (const string& fen : Defaults)
+              {
+                  StateListPtr states(new std::deque<StateInfo>(1));
+                  pos.set(fen, false, &states->back(), Threads.main());
+
+                  Search::LimitsType limits;
+                  limits.depth = depth;
+                  limits.startTime = now();
+
+                  Threads.start_thinking(pos, states, limits);
+                  Threads.main()->wait_for_search_finished();
+                  nodes += Threads.nodes_searched();
+              }
+
+              elapsed = now() - elapsed + 1;
+              nps.push_back(1000.0 * nodes / elapsed);
+              ms.push_back(double(elapsed));
+
+              uci_out_flush(); // Keep the progress line out of the CSV rows
+              cerr << "sweep: threads " << threads << ", hash " << hash
+                   << "MB, repeat " << r + 1 << '/' << repeats
+                   << ": " << uint64_t(nps.back()) << " nps" << endl;
+          }
+
+          sync_cout << threads << ',' << hash << ',' << repeats << ','
+                    << nodes << ','
+                    << uint64_t(median(nps)) << ',' << uint64_t(stddev(nps)) << ','
+                    << uint64_t(median(ms))  << ',' << uint64_t(stddev(ms)) << sync_endl;
+      }
+}
@@ -61,10 +61,55 @@ namespace {
   Bitboard RookTable[0x19000];  // To store rook attacks
   Bitboard BishopTable[0x1480]; // To store bishop attacks
 
+  // Predetermined magics for the 64-bit build, found once by the search in
+  // init_magics() (the fixed PRNG seeds make it fully deterministic) and
+  // baked in, so startup only pays for a single verification pass instead
+  // of the trial-and-error search. The 32-bit build uses a different magic
+  // layout and keeps searching at startup.
+
+  const Bitboard RookMagicInit[SQUARE_NB] = {
+    0xA80004000801220ULL,  0x8040004010002008ULL, 0x2080200010008008ULL, 0x1100100008210004ULL,
+    0xC200209084020008ULL, 0x2100010004000208ULL, 0x400081000822421ULL,  0x200010422048844ULL,
+    0x800800080400024ULL,  0x1402000401000ULL,    0x3000801000802001ULL, 0x4400800800100083ULL,
+    0x904802402480080ULL,  0x4040800400020080ULL, 0x18808042000100ULL,   0x4040800080004100ULL,
+    0x40048001458024ULL,   0xA0004000205000ULL,   0x3100808010002000ULL, 0x4825010010000820ULL,
+    0x5004808008000401ULL, 0x2024818004000A00ULL, 0x5808002000100ULL,    0x2100060004806104ULL,
+    0x80400880008421ULL,   0x4062220600410280ULL, 0x10A004A00108022ULL,  0x100080080080ULL,
+    0x21000500080010ULL,   0x44000202001008ULL,   0x100400080102ULL,     0xC020128200040545ULL,
+    0x80002000400040ULL,   0x804000802004ULL,     0x120022004080ULL,     0x10A386103001001ULL,
+    0x9010080080800400ULL, 0x8440020080800400ULL, 0x4228824001001ULL,    0x490A000084ULL,
+    0x80002000504000ULL,   0x200020005000C000ULL, 0x12088020420010ULL,   0x10010080080800ULL,
+    0x85001008010004ULL,   0x2000204008080ULL,    0x40413002040008ULL,   0x304081020004ULL,
+    0x80204000800080ULL,   0x3008804000290100ULL, 0x1010100080200080ULL, 0x2008100208028080ULL,
+    0x5000850800910100ULL, 0x8402019004680200ULL, 0x120911028020400ULL,  0x8044010200ULL,
+    0x20850200244012ULL,   0x20850200244012ULL,   0x102001040841ULL,     0x140900040A100021ULL,
+    0x200282410A102ULL,    0x200282410A102ULL,    0x200282410A102ULL,    0x4048240043802106ULL
+  };
+
+  const Bitboard BishopMagicInit[SQUARE_NB] = {
+    0x40106000A1160020ULL, 0x20010250810120ULL,   0x2010010220280081ULL, 0x2806004050C040ULL,
+    0x2021018000000ULL,    0x2001112010000400ULL, 0x881010120218080ULL,  0x1030820110010500ULL,
+    0x120222042400ULL,     0x2000020404040044ULL, 0x8000480094208000ULL, 0x3422A02000001ULL,
+    0xA220210100040ULL,    0x8004820202226000ULL, 0x18234854100800ULL,   0x100004042101040ULL,
+    0x4001004082820ULL,    0x10000810010048ULL,   0x1014004208081300ULL, 0x2080818802044202ULL,
+    0x40880C00A00100ULL,   0x80400200522010ULL,   0x1000188180B04ULL,    0x80249202020204ULL,
+    0x1004400004100410ULL, 0x13100A0022206ULL,    0x2148500001040080ULL, 0x4241080011004300ULL,
+    0x4020848004002000ULL, 0x10101380D1004100ULL, 0x8004422020284ULL,    0x1010A1041008080ULL,
+    0x808080400082121ULL,  0x808080400082121ULL,  0x91128200100C00ULL,   0x202200802010104ULL,
+    0x8C0A020200440085ULL, 0x1A0008080B10040ULL,  0x889520080122800ULL,  0x100902022202010AULL,
+    0x4081A0816002000ULL,  0x681208005000ULL,     0x8170840041008802ULL, 0xA00004200810805ULL,
+    0x830404408210100ULL,  0x2602208106006102ULL, 0x1048300680802628ULL, 0x2602208106006102ULL,
+    0x602010120110040ULL,  0x941010801043000ULL,  0x40440A210428ULL,     0x8240020880021ULL,
+    0x400002012048200ULL,  0xAC102001210220ULL,   0x220021002009900ULL,  0x84440C080A013080ULL,
+    0x1008044200440ULL,    0x4C04410841000ULL,    0x2000500104011130ULL, 0x1A0C010011C20229ULL,
+    0x44800112202200ULL,   0x434804908100424ULL,  0x300404822C08200ULL,  0x48081010008A2A80ULL
+  };
+
   typedef unsigned (Fn)(Square, Bitboard);
 
   void init_magics(Bitboard table[], Bitboard* attacks[], Bitboard magics[],
-                   Bitboard masks[], unsigned shifts[], Square deltas[], Fn index);
+                   Bitboard masks[], unsigned shifts[], Square deltas[], Fn index,
+                   const Bitboard magicInit[]);
 
   // bsf_index() returns the index into BSFTable[] to look up the bitscan. Uses
   // Matt Taylor's folding for 32 bit case, extended to 64 bit by Kim Walisch.
@@ -208,8 +253,8 @@ void Bitboards::init() {
   Square RookDeltas[] = { DELTA_N,  DELTA_E,  DELTA_S,  DELTA_W  };
   Square BishopDeltas[] = { DELTA_NE, DELTA_SE, DELTA_SW, DELTA_NW };
 
-  init_magics(RookTable, RookAttacks, RookMagics, RookMasks, RookShifts, RookDeltas, magic_index<ROOK>);
-  init_magics(BishopTable, BishopAttacks, BishopMagics, BishopMasks, BishopShifts, BishopDeltas, magic_index<BISHOP>);
+  init_magics(RookTable, RookAttacks, RookMagics, RookMasks, RookShifts, RookDeltas, magic_index<ROOK>, Is64Bit ? RookMagicInit : nullptr);
+  init_magics(BishopTable, BishopAttacks, BishopMagics, BishopMasks, BishopShifts, BishopDeltas, magic_index<BISHOP>, Is64Bit ? BishopMagicInit : nullptr);
 
   for (Square s1 = SQ_A1; s1 <= SQ_H8; ++s1)
   {
@@ -256,7 +301,8 @@ namespace {
   // use the so called "fancy" approach.
 
   void init_magics(Bitboard table[], Bitboard* attacks[], Bitboard magics[],
-                   Bitboard masks[], unsigned shifts[], Square deltas[], Fn index) {
+                   Bitboard masks[], unsigned shifts[], Square deltas[], Fn index,
+                   const Bitboard magicInit[]) {
 
     int seeds[][RANK_NB] = { { 8977, 44560, 54343, 38998,  5731, 95205, 104912, 17020 },
                              {  728, 10316, 55013, 32803, 12281, 15100,  16645,   255 } };
@@ -305,11 +351,18 @@ namespace {
         PRNG rng(seeds[Is64Bit][rank_of(s)]);
 
         // Find a magic for square 's' picking up an (almost) random number
-        // until we find the one that passes the verification test.
+        // until we find the one that passes the verification test. When a
+        // predetermined magic is available we try it first, so the search
+        // loop is never entered and building the database reduces to the
+        // single verification pass below.
+        bool predetermined = magicInit != nullptr;
         do {
-            do
-                magics[s] = rng.sparse_rand<Bitboard>();
-            while (popcount((magics[s] * masks[s]) >> 56) < 6);
+            if (predetermined)
+                magics[s] = magicInit[s], predetermined = false;
+            else
+                do
+                    magics[s] = rng.sparse_rand<Bitboard>();
+                while (popcount((magics[s] * masks[s]) >> 56) < 6);
 
             // A good magic must map every possible occupancy to an index that
             // looks up the correct sliding attack in the attacks[s] database.
@@ -132,8 +132,8 @@ Endgames::Endgames() {
 
 template<EndgameType E, typename T>
 void Endgames::add(const string& code) {
-  map<T>()[key(code, WHITE)] = std::unique_ptr<EndgameBase<T>>(new Endgame<E>(WHITE));
-  map<T>()[key(code, BLACK)] = std::unique_ptr<EndgameBase<T>>(new Endgame<E>(BLACK));
+  table<T>().insert(key(code, WHITE), new Endgame<E>(WHITE));
+  table<T>().insert(key(code, BLACK), new Endgame<E>(BLACK));
 }
 
 
@@ -21,7 +21,7 @@
 #ifndef ENDGAME_H_INCLUDED
 #define ENDGAME_H_INCLUDED
 
-#include <map>
+#include <cassert>
 #include <memory>
 #include <string>
 #include <type_traits>
@@ -96,29 +96,57 @@ private:
 
 
 /// The Endgames class stores the pointers to endgame evaluation and scaling
-/// base objects in two std::map. We use polymorphism to invoke the actual
-/// endgame function by calling its virtual operator().
+/// base objects in two small open-addressing hash tables. All entries are
+/// inserted once at construction time and the load factor is kept low, so
+/// probe() usually touches a single cache line instead of chasing the tree
+/// nodes of a std::map. We use polymorphism to invoke the actual endgame
+/// function by calling its virtual operator().
 
 class Endgames {
 
-  template<typename T> using Map = std::map<Key, std::unique_ptr<EndgameBase<T>>>;
+  template<typename T>
+  struct Table {
+
+    static const unsigned Size = 64; // Power of two, double the entry count
+
+    struct Bucket {
+      Key key = Key(0); // Material keys are never zero
+      std::unique_ptr<EndgameBase<T>> eg;
+    } buckets[Size];
+
+    // Linear probing: returns the bucket holding 'key', or the empty
+    // bucket where 'key' would be inserted.
+    Bucket& bucket(Key key) {
+      unsigned idx = unsigned(key) & (Size - 1);
+      while (buckets[idx].key && buckets[idx].key != key)
+          idx = (idx + 1) & (Size - 1);
+      return buckets[idx];
+    }
+
+    void insert(Key key, EndgameBase<T>* eg) {
+      Bucket& b = bucket(key);
+      assert(!b.eg);
+      b.key = key;
+      b.eg.reset(eg);
+    }
+  };
 
   template<EndgameType E, typename T = eg_type<E>>
   void add(const std::string& code);
 
   template<typename T>
-  Map<T>& map() {
-    return std::get<std::is_same<T, ScaleFactor>::value>(maps);
+  Table<T>& table() {
+    return std::get<std::is_same<T, ScaleFactor>::value>(tables);
   }
 
-  std::pair<Map<Value>, Map<ScaleFactor>> maps;
+  std::pair<Table<Value>, Table<ScaleFactor>> tables;
 
 public:
   Endgames();
 
   template<typename T>
   EndgameBase<T>* probe(Key key) {
-    return map<T>().count(key) ? map<T>()[key].get() : nullptr;
+    return table<T>().bucket(key).eg.get();
   }
 };
 
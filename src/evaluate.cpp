@@ -28,6 +28,7 @@
 #include "evaluate.h"
 #include "material.h"
 #include "pawns.h"
+#include "thread.h"
 
 namespace {
 
@@ -202,6 +203,11 @@ namespace {
   // happen in Chess960 games.
   const Score TrappedBishopA1H1 = S(50, 50);
 
+  // Threshold on the material, imbalance and pawn structure terms above
+  // which the remaining positional terms are skipped, as they are almost
+  // never big enough to bring the score back.
+  const Value LazyThreshold = Value(1500);
+
   #undef S
   #undef V
 
@@ -266,13 +272,24 @@ namespace {
                                                : Rank5BB | Rank4BB | Rank3BB);
     const Square* pl = pos.squares<Pt>(Us);
 
+    // Hoist the values that are invariant over the piece loop into locals:
+    // the occupancy seen by the sliding attack lookups (own queens, and for
+    // rooks also own rooks, are x-rayed through) and the EvalInfo fields
+    // read every iteration, which the compiler cannot cache in registers
+    // itself because the attackedBy updates below may alias them.
+    const Bitboard occupied = Pt == BISHOP ? pos.pieces() ^ pos.pieces(Us, QUEEN)
+                            : Pt ==   ROOK ? pos.pieces() ^ pos.pieces(Us, ROOK, QUEEN)
+                                           : pos.pieces();
+    const Bitboard mobArea = mobilityArea[Us];
+    const Bitboard kingRing = ei.kingRing[Them];
+
     ei.attackedBy[Us][Pt] = 0;
 
     while ((s = *pl++) != SQ_NONE)
     {
         // Find attacked squares, including x-ray attacks for bishops and rooks
-        b = Pt == BISHOP ? attacks_bb<BISHOP>(s, pos.pieces() ^ pos.pieces(Us, QUEEN))
-          : Pt ==   ROOK ? attacks_bb<  ROOK>(s, pos.pieces() ^ pos.pieces(Us, ROOK, QUEEN))
+        b = Pt == BISHOP ? attacks_bb<BISHOP>(s, occupied)
+          : Pt ==   ROOK ? attacks_bb<  ROOK>(s, occupied)
                          : pos.attacks_from<Pt>(s);
 
         if (ei.pinnedPieces[Us] & s)
@@ -281,7 +298,7 @@ namespace {
         ei.attackedBy2[Us] |= ei.attackedBy[Us][ALL_PIECES] & b;
         ei.attackedBy[Us][ALL_PIECES] |= ei.attackedBy[Us][Pt] |= b;
 
-        if (b & ei.kingRing[Them])
+        if (b & kingRing)
         {
             ei.kingAttackersCount[Us]++;
             ei.kingAttackersWeight[Us] += KingAttackWeights[Pt];
@@ -293,7 +310,7 @@ namespace {
                    | ei.attackedBy[Them][BISHOP]
                    | ei.attackedBy[Them][ROOK]);
 
-        int mob = popcount(b & mobilityArea[Us]);
+        int mob = popcount(b & mobArea);
 
         mobility[Us] += MobilityBonus[Pt][mob];
 
@@ -777,6 +794,14 @@ Value Eval::evaluate(const Position& pos) {
 
   assert(!pos.checkers());
 
+  // Probe the per-thread evaluation cache: the static eval depends only on
+  // the position, so a hit skips the whole evaluation. Tracing always runs
+  // the full evaluation, as it needs the individual terms.
+  Eval::Entry* e = pos.this_thread()->evalTable[pos.key()];
+
+  if (!DoTrace && e->key == pos.key())
+      return e->value;
+
   EvalInfo ei;
   Score score, mobility[COLOR_NB] = { SCORE_ZERO, SCORE_ZERO };
 
@@ -798,6 +823,21 @@ Value Eval::evaluate(const Position& pos) {
   ei.pi = Pawns::probe(pos);
   score += ei.pi->pawns_score();
 
+  // Early exit if the cheap terms already show a huge advantage: the
+  // expensive positional terms cannot realistically bring the score back,
+  // so one side is winning either way and the exact value hardly matters.
+  Value lazy = (mg_value(score) + eg_value(score)) / 2;
+
+  if (!DoTrace && abs(lazy) > LazyThreshold)
+  {
+      lazy = pos.side_to_move() == WHITE ? lazy : -lazy;
+
+      e->key = pos.key();
+      e->value = lazy;
+
+      return lazy;
+  }
+
   // Initialize attack and king safety bitboards
   ei.attackedBy[WHITE][ALL_PIECES] = ei.attackedBy[BLACK][ALL_PIECES] = 0;
   ei.attackedBy[WHITE][KING] = pos.attacks_from<KING>(pos.square<KING>(WHITE));
@@ -875,7 +915,12 @@ Value Eval::evaluate(const Position& pos) {
       Trace::add(TOTAL, score);
   }
 
-  return (pos.side_to_move() == WHITE ? v : -v) + Eval::Tempo; // Side to move point of view
+  v = (pos.side_to_move() == WHITE ? v : -v) + Eval::Tempo; // Side to move point of view
+
+  e->key = pos.key();
+  e->value = v;
+
+  return v;
 }
 
 // Explicit template instantiations
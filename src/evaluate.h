@@ -23,6 +23,7 @@
 
 #include <string>
 
+#include "misc.h"
 #include "types.h"
 
 class Position;
@@ -31,6 +32,17 @@ namespace Eval {
 
 const Value Tempo = Value(20); // Must be visible to search
 
+/// Eval::Entry caches a computed static evaluation, keyed by the position
+/// key. Looked up in evaluate() before running the full evaluation, in the
+/// same spirit as the pawn and material hash tables.
+
+struct Entry {
+  Key   key;
+  Value value;
+};
+
+typedef HashTable<Entry, 0x10000> Table;
+
 void init();
 std::string trace(const Position& pos);
 
@@ -126,6 +126,11 @@ Entry* probe(const Position& pos) {
   Key key = pos.material_key();
   Entry* e = pos.this_thread()->materialTable[key];
 
+#ifdef SEARCH_STATS
+  ++pos.this_thread()->searchStats.materialProbes;
+  pos.this_thread()->searchStats.materialHits += e->key == key;
+#endif
+
   if (e->key == key)
       return e;
 
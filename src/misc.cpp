@@ -18,10 +18,27 @@
   along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <mutex>
 #include <sstream>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
 
 #include "misc.h"
 #include "thread.h"
@@ -139,18 +156,97 @@ void dbg_print() {
 }
 
 
-/// Used to serialize access to std::cout to avoid multiple threads writing at
-/// the same time.
+namespace {
 
-std::ostream& operator<<(std::ostream& os, SyncCout sc) {
+/// AsyncOutput decouples the engine from the GUI pipe: every sync_cout /
+/// sync_endl bracket is formatted into a thread local buffer and enqueued
+/// as a whole message for a dedicated writer thread. A search thread thus
+/// never blocks on a backpressured pipe, and messages never interleave
+/// because only the writer touches std::cout.
+
+class AsyncOutput {
+
+  std::mutex mutex;
+  std::condition_variable cv, cvDrain;
+  std::deque<std::string> messages;
+  std::thread writer;
+  bool quit = false;
+  bool writing = false; // A popped message is still being written
+
+  void write_loop() {
+
+    std::string s;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lk(mutex);
+            cv.wait(lk, [&]{ return !messages.empty() || quit; });
+
+            if (messages.empty()) // Implies quit: drain before terminating
+                return;
+
+            s = std::move(messages.front());
+            messages.pop_front();
+            writing = true;
+        }
+        cout << s << std::flush;
+        {
+            std::lock_guard<std::mutex> lk(mutex);
+            writing = false;
+
+            if (messages.empty())
+                cvDrain.notify_all();
+        }
+    }
+  }
+
+public:
+  AsyncOutput() { writer = std::thread(&AsyncOutput::write_loop, this); }
+
+ ~AsyncOutput() {
+    { std::lock_guard<std::mutex> lk(mutex); quit = true; }
+    cv.notify_one();
+    writer.join();
+  }
+
+  static AsyncOutput& instance() { static AsyncOutput o; return o; }
+
+  static std::ostringstream& local() {
+    static thread_local std::ostringstream os;
+    return os;
+  }
+
+  void push(std::string s) {
+    { std::lock_guard<std::mutex> lk(mutex); messages.push_back(std::move(s)); }
+    cv.notify_one();
+  }
+
+  // Block until every queued message has been written out
+  void flush() {
+    std::unique_lock<std::mutex> lk(mutex);
+    cvDrain.wait(lk, [&]{ return messages.empty() && !writing; });
+  }
+};
+
+} // namespace
+
+std::ostream& uci_out() { return AsyncOutput::local(); }
+
+void uci_out_flush() { AsyncOutput::instance().flush(); }
 
-  static Mutex m;
 
-  if (sc == IO_LOCK)
-      m.lock();
+/// IO_LOCK opens an output bracket on the thread local buffer, IO_UNLOCK
+/// closes it and passes the message to the writer thread.
+
+std::ostream& operator<<(std::ostream& os, SyncCout sc) {
 
   if (sc == IO_UNLOCK)
-      m.unlock();
+  {
+      std::ostringstream& buf = AsyncOutput::local();
+      AsyncOutput::instance().push(buf.str());
+      buf.str("");
+  }
 
   return os;
 }
@@ -185,3 +281,212 @@ void prefetch(void* addr) {
 }
 
 #endif
+
+
+/// aligned_ttmem_alloc() allocates the memory for the transposition table,
+/// if requested backed by large (huge) pages. With multi-gigabyte tables
+/// nearly every probe misses the dTLB when backed by standard 4K pages, so
+/// 2MB pages are worth a measurable speedup. On Linux we allocate 2MB-aligned
+/// memory and ask the kernel for transparent huge pages with madvise(), on
+/// Windows we try VirtualAlloc() with MEM_LARGE_PAGES. Both fall back
+/// gracefully to normal pages when huge ones are not available. The returned
+/// pointer must be freed with aligned_ttmem_free().
+
+#ifdef _WIN32
+
+void* aligned_ttmem_alloc(size_t size, bool largePages) {
+
+  if (largePages)
+  {
+      // Large pages require the SeLockMemoryPrivilege privilege, try to
+      // acquire it and silently fall back to normal pages on failure.
+      HANDLE token;
+      TOKEN_PRIVILEGES tp;
+
+      if (   OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES, &token)
+          && LookupPrivilegeValue(NULL, SE_LOCK_MEMORY_NAME, &tp.Privileges[0].Luid))
+      {
+          tp.PrivilegeCount = 1;
+          tp.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+          AdjustTokenPrivileges(token, FALSE, &tp, 0, NULL, NULL);
+          CloseHandle(token);
+      }
+
+      size_t largePageSize = GetLargePageMinimum();
+
+      if (largePageSize)
+      {
+          size_t roundedSize = (size + largePageSize - 1) & ~(largePageSize - 1);
+          void* mem = VirtualAlloc(NULL, roundedSize, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+                                   PAGE_READWRITE);
+          if (mem)
+              return mem;
+      }
+  }
+
+  return VirtualAlloc(NULL, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+}
+
+void aligned_ttmem_free(void* mem) {
+
+  if (mem)
+      VirtualFree(mem, 0, MEM_RELEASE);
+}
+
+#elif defined(__linux__)
+
+void* aligned_ttmem_alloc(size_t size, bool largePages) {
+
+  const size_t alignment = largePages ? 2 * 1024 * 1024 : 4096;
+  size_t roundedSize = (size + alignment - 1) & ~(alignment - 1);
+  void* mem;
+
+  if (posix_memalign(&mem, alignment, roundedSize))
+      return nullptr;
+
+  if (largePages)
+      madvise(mem, roundedSize, MADV_HUGEPAGE);
+
+  return mem;
+}
+
+void aligned_ttmem_free(void* mem) { free(mem); }
+
+#else
+
+void* aligned_ttmem_alloc(size_t size, bool) { return malloc(size + 63); }
+void aligned_ttmem_free(void* mem) { free(mem); }
+
+#endif
+
+
+/// On multi-socket machines Lazy SMP suffers when threads are free to migrate
+/// between NUMA nodes: remote accesses to the shared hash and to the per-thread
+/// history tables cost several times a local access. bind_this_thread() pins
+/// the calling thread, number 'idx' in the pool, to a fixed CPU, distributing
+/// consecutive threads round-robin across the NUMA nodes. On hybrid CPUs the
+/// per-node CPU lists are ordered fastest core first, so the main thread gets
+/// the fastest core and efficiency cores are used only once the pool outgrows
+/// the performance cores. interleave_pages() spreads the pages of a big shared
+/// allocation (the transposition table) evenly over all nodes. Both are no-ops
+/// on platforms where we have no portable way to query the topology.
+
+#ifdef __linux__
+
+namespace {
+
+// Parse a kernel cpulist string like "0-15,32-47" into a vector of CPU ids
+std::vector<int> parse_cpulist(const std::string& s) {
+
+  std::vector<int> cpus;
+  std::stringstream ss(s);
+  std::string range;
+
+  while (std::getline(ss, range, ','))
+  {
+      size_t dash = range.find('-');
+      int first = stoi(range.substr(0, dash));
+      int last = dash == std::string::npos ? first : stoi(range.substr(dash + 1));
+
+      for (int c = first; c <= last; ++c)
+          cpus.push_back(c);
+  }
+  return cpus;
+}
+
+// Maximum frequency of a CPU in kHz, or 0 when the kernel exposes no cpufreq
+// information, in which case all cores are assumed to be equal.
+int max_freq(int cpu) {
+
+  int khz = 0;
+  ifstream f("/sys/devices/system/cpu/cpu" + std::to_string(cpu)
+             + "/cpufreq/cpuinfo_max_freq");
+  f >> khz;
+  return khz;
+}
+
+// Per-node CPU lists, read once from sysfs. A machine without NUMA support
+// in the kernel simply appears as a single node holding every CPU.
+const std::vector<std::vector<int>>& numa_nodes() {
+
+  static std::vector<std::vector<int>> nodes;
+  static bool init_done = false;
+
+  if (!init_done)
+  {
+      for (int n = 0; ; ++n)
+      {
+          ifstream f("/sys/devices/system/node/node" + std::to_string(n) + "/cpulist");
+          if (!f.is_open())
+              break;
+
+          std::string line;
+          std::getline(f, line);
+          nodes.push_back(parse_cpulist(line));
+      }
+
+      if (nodes.empty()) // Fall back to a flat topology
+      {
+          nodes.push_back({});
+          for (int c = 0; c < int(std::thread::hardware_concurrency()); ++c)
+              nodes[0].push_back(c);
+      }
+
+      // Performance cores first: on hybrid CPUs thread 'idx' is bound to the
+      // idx-th fastest core, so the main thread lands on a performance core
+      // and efficiency cores are filled last. The sort is stable, so machines
+      // with uniform cores keep the kernel's enumeration order.
+      for (auto& cpus : nodes)
+          std::stable_sort(cpus.begin(), cpus.end(),
+                           [](int a, int b) { return max_freq(a) > max_freq(b); });
+
+      init_done = true;
+  }
+  return nodes;
+}
+
+} // namespace
+
+void bind_this_thread(size_t idx) {
+
+  const auto& nodes = numa_nodes();
+  const auto& cpus = nodes[idx % nodes.size()];
+
+  if (cpus.empty())
+      return;
+
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpus[(idx / nodes.size()) % cpus.size()], &set);
+  pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+void interleave_pages(void* addr, size_t len) {
+
+#ifdef SYS_mbind
+  const int MPOL_INTERLEAVE = 3;
+
+  if (numa_nodes().size() < 2)
+      return;
+
+  unsigned long nodeMask = (1UL << numa_nodes().size()) - 1;
+
+  // Round the region to page boundaries as required by mbind()
+  uintptr_t pageSize = sysconf(_SC_PAGESIZE);
+  uintptr_t first = (uintptr_t(addr) + pageSize - 1) & ~(pageSize - 1);
+  uintptr_t last = (uintptr_t(addr) + len) & ~(pageSize - 1);
+
+  if (first < last)
+      syscall(SYS_mbind, first, last - first, MPOL_INTERLEAVE,
+              &nodeMask, 8 * sizeof(nodeMask), 0);
+#else
+  (void)addr, (void)len;
+#endif
+}
+
+#else
+
+void bind_this_thread(size_t) {}
+void interleave_pages(void*, size_t) {}
+
+#endif
@@ -21,6 +21,7 @@
 #ifndef MISC_H_INCLUDED
 #define MISC_H_INCLUDED
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
 #include <ostream>
@@ -32,6 +33,10 @@
 const std::string engine_info(bool to_uci = false);
 void prefetch(void* addr);
 void start_logger(const std::string& fname);
+void bind_this_thread(size_t idx);
+void interleave_pages(void* addr, size_t len);
+void* aligned_ttmem_alloc(size_t size, bool largePages);
+void aligned_ttmem_free(void* mem);
 
 void dbg_hit_on(bool b);
 void dbg_hit_on(bool c, bool b);
@@ -47,7 +52,22 @@ inline TimePoint now() {
 
 template<class Entry, int Size>
 struct HashTable {
-  Entry* operator[](Key key) { return &table[(uint32_t)key & (Size - 1)]; }
+  Entry* operator[](Key key) { return &table[(uint32_t)key & (table.size() - 1)]; }
+
+  // clear() resets all entries to their default-constructed state
+  void clear() { std::fill(table.begin(), table.end(), Entry()); }
+
+  // resize() reallocates the table, cleared, with the given number of entries
+  // rounded down to a power of two. Size is only the default.
+  void resize(size_t entries) {
+
+    size_t pow2 = 1;
+    while (2 * pow2 <= entries)
+        pow2 *= 2;
+
+    if (pow2 != table.size())
+        std::vector<Entry>(pow2).swap(table);
+  }
 
 private:
   std::vector<Entry> table = std::vector<Entry>(Size);
@@ -57,7 +77,15 @@ private:
 enum SyncCout { IO_LOCK, IO_UNLOCK };
 std::ostream& operator<<(std::ostream&, SyncCout);
 
-#define sync_cout std::cout << IO_LOCK
+// uci_out() returns a thread local buffer stream: a sync_cout/sync_endl
+// bracket formats into it and IO_UNLOCK hands the finished message to a
+// dedicated writer thread, so search threads never block on the GUI pipe.
+// uci_out_flush() blocks until every queued message has been written out,
+// ordering direct std::cerr writes against the queued traffic.
+std::ostream& uci_out();
+void uci_out_flush();
+
+#define sync_cout uci_out() << IO_LOCK
 #define sync_endl std::endl << IO_UNLOCK
 
 
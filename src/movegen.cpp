@@ -409,6 +409,21 @@ ExtMove* generate<LEGAL>(const Position& pos, ExtMove* moveList) {
 
   moveList = pos.checkers() ? generate<EVASIONS    >(pos, moveList)
                             : generate<NON_EVASIONS>(pos, moveList);
+
+  // In the common case of nothing pinned, no check and no en-passant square,
+  // only king moves can be illegal, and generate_all() emits them last: verify
+  // just that trailing block, walking it backwards so that a move pulled in
+  // from the end to fill a hole has already been verified.
+  if (!pinned && !pos.checkers() && pos.ep_square() == SQ_NONE)
+  {
+      ExtMove* it = moveList;
+      while (it != cur && from_sq(*(it - 1)) == ksq)
+          if (!pos.legal(*--it, pinned))
+              *it = (--moveList)->move;
+
+      return moveList;
+  }
+
   while (cur != moveList)
       if (   (pinned || from_sq(*cur) == ksq || type_of(*cur) == ENPASSANT)
           && !pos.legal(*cur, pinned))
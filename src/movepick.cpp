@@ -35,6 +35,11 @@ namespace {
     STOP
   };
 
+  // An always-zero stats table, used instead of a null counter move history
+  // pointer so that score<QUIETS>() reads it unconditionally and the hot
+  // scoring loop carries no per-move branches.
+  CounterMoveStats EmptyStats;
+
   // Our insertion sort, which is guaranteed to be stable, as it should be
   void insertion_sort(ExtMove* begin, ExtMove* end)
   {
@@ -116,7 +121,7 @@ MovePicker::MovePicker(const Position& p, Move ttm, Value th)
   ttMove =   ttm
           && pos.pseudo_legal(ttm)
           && pos.capture(ttm)
-          && pos.see(ttm) > threshold ? ttm : MOVE_NONE;
+          && pos.see_ge(ttm, threshold + 1) ? ttm : MOVE_NONE;
 
   endMoves += (ttMove != MOVE_NONE);
 }
@@ -144,18 +149,25 @@ void MovePicker::score<QUIETS>() {
   const HistoryStats& history = pos.this_thread()->history;
   const FromToStats& fromTo = pos.this_thread()->fromTo;
 
-  const CounterMoveStats* cm = (ss-1)->counterMoves;
-  const CounterMoveStats* fm = (ss-2)->counterMoves;
-  const CounterMoveStats* f2 = (ss-4)->counterMoves;
+  const CounterMoveStats& cm = (ss-1)->counterMoves ? *(ss-1)->counterMoves : EmptyStats;
+  const CounterMoveStats& fm = (ss-2)->counterMoves ? *(ss-2)->counterMoves : EmptyStats;
+  const CounterMoveStats& f2 = (ss-4)->counterMoves ? *(ss-4)->counterMoves : EmptyStats;
 
   Color c = pos.side_to_move();
 
+  // The five table lookups per move are independent, so with the null checks
+  // hoisted out of the loop they all issue in parallel.
   for (auto& m : *this)
-      m.value =      history[pos.moved_piece(m)][to_sq(m)]
-               + (cm ? (*cm)[pos.moved_piece(m)][to_sq(m)] : VALUE_ZERO)
-               + (fm ? (*fm)[pos.moved_piece(m)][to_sq(m)] : VALUE_ZERO)
-               + (f2 ? (*f2)[pos.moved_piece(m)][to_sq(m)] : VALUE_ZERO)
+  {
+      const Piece pc = pos.moved_piece(m);
+      const Square to = to_sq(m);
+
+      m.value =  history[pc][to]
+               + cm[pc][to]
+               + fm[pc][to]
+               + f2[pc][to]
                + fromTo.get(c, m);
+  }
 }
 
 template<>
@@ -269,7 +281,7 @@ Move MovePicker::next_move() {
           move = pick_best(cur++, endMoves);
           if (move != ttMove)
           {
-              if (pos.see_sign(move) >= VALUE_ZERO)
+              if (pos.see_ge(move))
                   return move;
 
               // Losing capture, move it to the tail of the array
@@ -306,7 +318,7 @@ Move MovePicker::next_move() {
 
       case PROBCUT_CAPTURES:
            move = pick_best(cur++, endMoves);
-           if (move != ttMove && pos.see(move) > threshold)
+           if (move != ttMove && pos.see_ge(move, threshold + 1))
                return move;
            break;
 
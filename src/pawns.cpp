@@ -212,6 +212,11 @@ Entry* probe(const Position& pos) {
   Key key = pos.pawn_key();
   Entry* e = pos.this_thread()->pawnsTable[key];
 
+#ifdef SEARCH_STATS
+  ++pos.this_thread()->searchStats.pawnProbes;
+  pos.this_thread()->searchStats.pawnHits += e->key == key;
+#endif
+
   if (e->key == key)
       return e;
 
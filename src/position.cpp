@@ -284,6 +284,88 @@ Position& Position::set(const string& fenStr, bool isChess960, StateInfo* si, Th
 }
 
 
+/// Position::set() overload initializes the position object from a packed
+/// binary record, skipping FEN parsing entirely. The record is trusted to
+/// come from pack(), so only the en passant square is re-validated. Packed
+/// records cannot encode Chess960 castling rights, hence chess960 is false.
+
+Position& Position::set(const PackedPosition& packed, StateInfo* si, Thread* th) {
+
+  std::memset(this, 0, sizeof(Position));
+  std::memset(si, 0, sizeof(StateInfo));
+  std::fill_n(&pieceList[0][0][0], sizeof(pieceList) / sizeof(Square), SQ_NONE);
+  st = si;
+
+  Bitboard occupied = 0;
+  for (int i = 0; i < 8; ++i)
+      occupied |= Bitboard(packed.occupancy[i]) << (8 * i);
+
+  for (int n = 0; occupied; ++n)
+  {
+      Piece pc = Piece((packed.pieces[n / 2] >> (4 * (n % 2))) & 0xF);
+      put_piece(color_of(pc), type_of(pc), pop_lsb(&occupied));
+  }
+
+  sideToMove = Color(packed.flags & 1);
+
+  for (int i = 0; i < 4; ++i)
+      if (packed.flags & (2 << i))
+      {
+          Color c = Color(i / 2);
+          set_castling_right(c, relative_square(c, i % 2 ? SQ_A1 : SQ_H1));
+      }
+
+  if (   packed.epSquare < SQUARE_NB
+      && (attackers_to(Square(packed.epSquare)) & pieces(sideToMove, PAWN)))
+      st->epSquare = Square(packed.epSquare);
+  else
+      st->epSquare = SQ_NONE;
+
+  st->rule50 = packed.rule50;
+
+  gamePly = packed.fullMove[0] | (packed.fullMove[1] << 8);
+  gamePly = std::max(2 * (gamePly - 1), 0) + (sideToMove == BLACK);
+
+  chess960 = false;
+  thisThread = th;
+  set_state(st);
+
+  assert(pos_is_ok());
+
+  return *this;
+}
+
+
+/// Position::pack() serializes the position into the packed binary format
+/// read back by the set() overload above.
+
+void Position::pack(PackedPosition& packed) const {
+
+  std::memset(&packed, 0, sizeof(PackedPosition));
+
+  Bitboard occupied = pieces();
+  for (int i = 0; i < 8; ++i)
+      packed.occupancy[i] = uint8_t(occupied >> (8 * i));
+
+  for (int n = 0; occupied; ++n)
+      packed.pieces[n / 2] |= uint8_t(piece_on(pop_lsb(&occupied))) << (4 * (n % 2));
+
+  packed.flags = uint8_t(sideToMove);
+
+  const CastlingRight rights[] = { WHITE_OO, WHITE_OOO, BLACK_OO, BLACK_OOO };
+  for (int i = 0; i < 4; ++i)
+      if (can_castle(rights[i]))
+          packed.flags |= uint8_t(2 << i);
+
+  packed.epSquare = uint8_t(ep_square() == SQ_NONE ? SQUARE_NB : ep_square());
+  packed.rule50 = uint8_t(st->rule50);
+
+  int fullMove = 1 + (gamePly - (sideToMove == BLACK)) / 2;
+  packed.fullMove[0] = uint8_t(fullMove);
+  packed.fullMove[1] = uint8_t(fullMove >> 8);
+}
+
+
 /// Position::set_castling_right() is a helper function used to set castling
 /// rights given the corresponding color and the rook starting square.
 
@@ -636,11 +718,27 @@ bool Position::gives_check(Move m, const CheckInfo& ci) const {
 
 /// Position::do_move() makes a move, and saves all information necessary
 /// to a StateInfo object. The move is assumed to be legal. Pseudo-legal
-/// moves should be filtered out before this function is called.
+/// moves should be filtered out before this function is called. The public
+/// overload dispatches once on the move type to a worker templated on it,
+/// so that the promotion, en-passant and castling special cases fold away
+/// at compile time from the common quiet and capture path.
+
+void Position::do_move(Move m, StateInfo& newSt, bool givesCheck) {
+
+  switch (type_of(m))
+  {
+  case PROMOTION: do_move<PROMOTION>(m, newSt, givesCheck); break;
+  case ENPASSANT: do_move<ENPASSANT>(m, newSt, givesCheck); break;
+  case CASTLING:  do_move< CASTLING>(m, newSt, givesCheck); break;
+  default:        do_move<   NORMAL>(m, newSt, givesCheck); break;
+  }
+}
 
+template<MoveType T>
 void Position::do_move(Move m, StateInfo& newSt, bool givesCheck) {
 
   assert(is_ok(m));
+  assert(type_of(m) == T);
   assert(&newSt != st);
 
   ++nodes;
@@ -664,13 +762,13 @@ void Position::do_move(Move m, StateInfo& newSt, bool givesCheck) {
   Square from = from_sq(m);
   Square to = to_sq(m);
   PieceType pt = type_of(piece_on(from));
-  PieceType captured = type_of(m) == ENPASSANT ? PAWN : type_of(piece_on(to));
+  PieceType captured = T == ENPASSANT ? PAWN : type_of(piece_on(to));
 
   assert(color_of(piece_on(from)) == us);
-  assert(piece_on(to) == NO_PIECE || color_of(piece_on(to)) == (type_of(m) != CASTLING ? them : us));
+  assert(piece_on(to) == NO_PIECE || color_of(piece_on(to)) == (T != CASTLING ? them : us));
   assert(captured != KING);
 
-  if (type_of(m) == CASTLING)
+  if (T == CASTLING)
   {
       assert(pt == KING);
 
@@ -690,7 +788,7 @@ void Position::do_move(Move m, StateInfo& newSt, bool givesCheck) {
       // update non-pawn material.
       if (captured == PAWN)
       {
-          if (type_of(m) == ENPASSANT)
+          if (T == ENPASSANT)
           {
               capsq -= pawn_push(us);
 
@@ -742,21 +840,23 @@ void Position::do_move(Move m, StateInfo& newSt, bool givesCheck) {
   }
 
   // Move the piece. The tricky Chess960 castling is handled earlier
-  if (type_of(m) != CASTLING)
+  if (T != CASTLING)
       move_piece(us, pt, from, to);
 
   // If the moving piece is a pawn do some special extra work
   if (pt == PAWN)
   {
-      // Set en-passant square if the moved pawn can be captured
-      if (   (int(to) ^ int(from)) == 16
+      // Set en-passant square if the moved pawn can be captured. Only a
+      // normal move can be a double push.
+      if (   T == NORMAL
+          && (int(to) ^ int(from)) == 16
           && (attacks_from<PAWN>(to - pawn_push(us), us) & pieces(them, PAWN)))
       {
           st->epSquare = (from + to) / 2;
           k ^= Zobrist::enpassant[file_of(st->epSquare)];
       }
 
-      else if (type_of(m) == PROMOTION)
+      else if (T == PROMOTION)
       {
           PieceType promotion = promotion_type(m);
 
@@ -793,8 +893,10 @@ void Position::do_move(Move m, StateInfo& newSt, bool givesCheck) {
   // Set capture piece
   st->capturedType = captured;
 
-  // Update the key with the final value
+  // Update the key with the final value and prefetch access to the
+  // evaluation cache, like the pawn and material table prefetches above
   st->key = k;
+  prefetch(thisThread->evalTable[k]);
 
   // Calculate checkers bitboard (if move gives check)
   st->checkersBB = givesCheck ? attackers_to(square<KING>(them)) & pieces(us) : 0;
@@ -946,6 +1048,36 @@ Key Position::key_after(Move m) const {
 }
 
 
+/// Position::pawn_key_after() and Position::material_key_after() compute the
+/// pawn and material hash keys after the given move, used to prefetch the
+/// corresponding hash table entries of the child position before do_move()
+/// runs. Like key_after() they don't recognize special moves, which only
+/// costs a useless prefetch now and then.
+
+Key Position::pawn_key_after(Move m) const {
+
+  Square from = from_sq(m), to = to_sq(m);
+  Key k = st->pawnKey;
+
+  if (type_of(piece_on(from)) == PAWN)
+      k ^= Zobrist::psq[sideToMove][PAWN][from] ^ Zobrist::psq[sideToMove][PAWN][to];
+
+  if (type_of(piece_on(to)) == PAWN)
+      k ^= Zobrist::psq[~sideToMove][PAWN][to];
+
+  return k;
+}
+
+Key Position::material_key_after(Move m) const {
+
+  PieceType captured = type_of(piece_on(to_sq(m)));
+
+  return captured ? st->materialKey
+                  ^ Zobrist::psq[~sideToMove][captured][pieceCount[~sideToMove][captured] - 1]
+                  : st->materialKey;
+}
+
+
 /// Position::see() is a static exchange evaluator: It tries to estimate the
 /// material gain or loss resulting from a move.
 
@@ -1032,6 +1164,84 @@ Value Position::see(Move m) const {
 }
 
 
+/// Position::see_ge() tests if the SEE value of move is greater or equal to the
+/// given value. Callers interested only in a bound on the exchange result, like
+/// the pruning conditions in search, should prefer this to see(): the exchange
+/// evaluation terminates as soon as the side to move can stand pat at or above
+/// (respectively, hold the exchange below) the threshold, instead of always
+/// running the full swap list.
+
+bool Position::see_ge(Move m, Value v) const {
+
+  assert(is_ok(m));
+
+  // Castling moves are implemented as king capturing the rook so cannot be
+  // handled correctly. Simply assume the SEE value is VALUE_ZERO that is
+  // always correct unless in the rare case the rook ends up under attack.
+  if (type_of(m) == CASTLING)
+      return VALUE_ZERO >= v;
+
+  Square from = from_sq(m), to = to_sq(m);
+  PieceType nextVictim = type_of(piece_on(from));
+  Color stm = ~color_of(piece_on(from)); // First consider opponent's move
+  Value balance; // Values of the pieces taken by us minus opponent's ones
+  Bitboard occupied, stmAttackers;
+
+  if (type_of(m) == ENPASSANT)
+  {
+      occupied = SquareBB[to - pawn_push(~stm)]; // Remove the captured pawn
+      balance = PieceValue[MG][PAWN];
+  }
+  else
+  {
+      balance = PieceValue[MG][piece_on(to)];
+      occupied = 0;
+  }
+
+  if (balance < v)
+      return false;
+
+  if (nextVictim == KING)
+      return true;
+
+  balance -= PieceValue[MG][nextVictim];
+
+  if (balance >= v)
+      return true;
+
+  bool relativeStm = true; // True if the opponent is to move
+  occupied ^= pieces() ^ from ^ to;
+
+  // Find all attackers to the destination square, with the moving piece
+  // removed, but possibly an X-ray attacker added behind it.
+  Bitboard attackers = attackers_to(to, occupied) & occupied;
+
+  while (true)
+  {
+      stmAttackers = attackers & pieces(stm);
+
+      if (!stmAttackers)
+          return relativeStm;
+
+      // Locate and remove the next least valuable attacker
+      nextVictim = min_attacker<PAWN>(byTypeBB, to, stmAttackers, occupied, attackers);
+
+      if (nextVictim == KING)
+          return relativeStm == bool(attackers & pieces(~stm));
+
+      balance += relativeStm ?  PieceValue[MG][nextVictim]
+                             : -PieceValue[MG][nextVictim];
+
+      relativeStm = !relativeStm;
+
+      if (relativeStm == (balance >= v))
+          return relativeStm;
+
+      stm = ~stm;
+  }
+}
+
+
 /// Position::is_draw() tests whether the position is drawn by 50-move rule
 /// or by repetition. It does not detect stalemates.
 
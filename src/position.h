@@ -82,6 +82,27 @@ struct StateInfo {
 typedef std::unique_ptr<std::deque<StateInfo>> StateListPtr;
 
 
+/// PackedPosition is a fixed-size, 32 bytes binary encoding of a position,
+/// built for bulk ingestion: a file of packed records can be read straight
+/// into memory and handed to Position::set() without any FEN parsing. The
+/// occupancy bitboard is followed by one nibble per occupied square, taken
+/// in ascending square order. All multi-byte fields are little-endian, so
+/// files are portable across machines. Chess960 castling rights are not
+/// representable: packed files hold standard chess positions only.
+
+struct PackedPosition {
+  uint8_t occupancy[8]; // Occupied squares bitboard, little-endian
+  uint8_t pieces[16];   // One nibble (a Piece value) per occupied square, low nibble first
+  uint8_t flags;        // Bit 0: black to move, bits 1-4: KQkq castling rights
+  uint8_t epSquare;     // En passant square, SQUARE_NB if none
+  uint8_t rule50;       // Halfmove clock
+  uint8_t fullMove[2];  // Fullmove number, little-endian
+  uint8_t padding[3];   // Zero filled
+};
+
+static_assert(sizeof(PackedPosition) == 32, "PackedPosition size is part of the file format");
+
+
 /// Position class stores information regarding the board representation as
 /// pieces, side to move, hash keys, castling info, etc. Important methods are
 /// do_move() and undo_move(), used by the search to update node info when
@@ -100,6 +121,10 @@ public:
   Position& set(const std::string& fenStr, bool isChess960, StateInfo* si, Thread* th);
   const std::string fen() const;
 
+  // Packed binary input/output
+  Position& set(const PackedPosition& packed, StateInfo* si, Thread* th);
+  void pack(PackedPosition& packed) const;
+
   // Position representation
   Bitboard pieces() const;
   Bitboard pieces(PieceType pt) const;
@@ -156,10 +181,13 @@ public:
   // Static exchange evaluation
   Value see(Move m) const;
   Value see_sign(Move m) const;
+  bool see_ge(Move m, Value v = VALUE_ZERO) const;
 
   // Accessing hash keys
   Key key() const;
   Key key_after(Move m) const;
+  Key pawn_key_after(Move m) const;
+  Key material_key_after(Move m) const;
   Key exclusion_key() const;
   Key material_key() const;
   Key pawn_key() const;
@@ -190,6 +218,8 @@ private:
   void put_piece(Color c, PieceType pt, Square s);
   void remove_piece(Color c, PieceType pt, Square s);
   void move_piece(Color c, PieceType pt, Square from, Square to);
+  template<MoveType T>
+  void do_move(Move m, StateInfo& st, bool givesCheck);
   template<bool Do>
   void do_castling(Color us, Square from, Square& to, Square& rfrom, Square& rto);
 
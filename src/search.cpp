@@ -19,9 +19,12 @@
 */
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
 #include <cmath>
 #include <cstring>   // For std::memset
+#include <iomanip>
 #include <iostream>
 #include <sstream>
 
@@ -126,39 +129,91 @@ namespace {
     Move pv[3];
   };
 
-  // Set of rows with half bits set to 1 and half to 0. It is used to allocate
-  // the search depths across the threads.
-  typedef std::vector<int> Row;
-
-  const Row HalfDensity[] = {
-    {0, 1},
-    {1, 0},
-    {0, 0, 1, 1},
-    {0, 1, 1, 0},
-    {1, 1, 0, 0},
-    {1, 0, 0, 1},
-    {0, 0, 0, 1, 1, 1},
-    {0, 0, 1, 1, 1, 0},
-    {0, 1, 1, 1, 0, 0},
-    {1, 1, 1, 0, 0, 0},
-    {1, 1, 0, 0, 0, 1},
-    {1, 0, 0, 0, 1, 1},
-    {0, 0, 0, 0, 1, 1, 1, 1},
-    {0, 0, 0, 1, 1, 1, 1, 0},
-    {0, 0, 1, 1, 1, 1, 0 ,0},
-    {0, 1, 1, 1, 1, 0, 0 ,0},
-    {1, 1, 1, 1, 0, 0, 0 ,0},
-    {1, 1, 1, 0, 0, 0, 0 ,1},
-    {1, 1, 0, 0, 0, 0, 1 ,1},
-    {1, 0, 0, 0, 0, 1, 1 ,1},
+  // Breadcrumbs are used to mark nodes as being searched by a given thread,
+  // in the spirit of ABDADA. A thread that reaches a node another thread is
+  // already busy on reduces its late moves a bit more, steering the threads
+  // towards different siblings instead of burning the same subtree.
+  struct Breadcrumb {
+    std::atomic<Thread*> thread;
+    std::atomic<Key> key;
   };
 
-  const size_t HalfDensitySize = std::extent<decltype(HalfDensity)>::value;
+  std::array<Breadcrumb, 1024> breadcrumbs;
+
+  // ThreadHolding structure keeps track of which thread left breadcrumbs at
+  // the given node. Only the first thread to visit a shallow node leaves a
+  // crumb there, and removes it when done; later visitors just observe it.
+  struct ThreadHolding {
+
+    explicit ThreadHolding(Thread* thisThread, Key posKey, int ply) {
+
+      location = ply < 8 ? &breadcrumbs[posKey & (breadcrumbs.size() - 1)] : nullptr;
+      otherThread = owning = false;
+
+      if (location)
+      {
+          // See if another already marked this location, if not, mark it
+          Thread* tmp = location->thread.load(std::memory_order_relaxed);
+          if (tmp == nullptr)
+          {
+              location->thread.store(thisThread, std::memory_order_relaxed);
+              location->key.store(posKey, std::memory_order_relaxed);
+              owning = true;
+          }
+          else if (   tmp != thisThread
+                   && location->key.load(std::memory_order_relaxed) == posKey)
+              otherThread = true;
+      }
+    }
+
+    ~ThreadHolding() {
+      if (owning) // Free the marked location
+          location->thread.store(nullptr, std::memory_order_relaxed);
+    }
+
+    bool marked() const { return otherThread; }
+
+  private:
+    Breadcrumb* location;
+    bool otherThread, owning;
+  };
+
+  // ContinuationHint remembers, keyed by position, what the previous search
+  // learned about the position it expected to face next: the move its PV
+  // continued with there and the score, from that position's point of view.
+  // When a GUI walks through a game with position/go pairs, the next root is
+  // almost always this predicted child, and seeding the new search from the
+  // hint makes its first iterations nearly free.
+
+  struct ContinuationHint {
+    Key key = 0;
+    Move move = MOVE_NONE;
+    Value score = VALUE_NONE;
+  };
 
   EasyMoveManager EasyMove;
+  ContinuationHint Continuation;
   Value DrawValue[COLOR_NB];
   CounterMoveHistoryStats CounterMoveHistory;
 
+  // Generation stamps for lazy clearing of CounterMoveHistory. The table is
+  // several megabytes, so instead of zeroing it in full on every new game,
+  // Search::clear() just bumps the generation and each [piece][to] sub-table
+  // is zeroed on first use in the new game, much like stale TT entries age
+  // out through TTEntry's generation8.
+  int CMHGeneration[PIECE_NB][SQUARE_NB];
+  int CMHCurrentGen;
+
+  CounterMoveStats* cm_history(Piece pc, Square to) {
+
+    if (CMHGeneration[pc][to] != CMHCurrentGen)
+    {
+        CMHGeneration[pc][to] = CMHCurrentGen;
+        CounterMoveHistory[pc][to].clear();
+    }
+    return &CounterMoveHistory[pc][to];
+  }
+
   template <NodeType NT>
   Value search(Position& pos, Stack* ss, Value alpha, Value beta, Depth depth, bool cutNode);
 
@@ -207,19 +262,94 @@ void Search::init() {
 void Search::clear() {
 
   TT.clear();
-  CounterMoveHistory.clear();
+
+  // Invalidate the global countermove history lazily: bumping the generation
+  // makes cm_history() zero each sub-table on its first use in the new game,
+  // so we avoid a multi-megabyte memset between games.
+  ++CMHCurrentGen;
 
   for (Thread* th : Threads)
   {
       th->history.clear();
       th->counterMoves.clear();
       th->fromTo.clear();
+
+#ifdef SEARCH_STATS
+      th->searchStats.clear();
+#endif
   }
 
+  Continuation = ContinuationHint();
   Threads.main()->previousScore = VALUE_INFINITE;
 }
 
 
+/// Search::print_stats() implements the "searchstats" command: it prints the
+/// search tree counters aggregated over all threads, as rates at the level
+/// where each decision is taken. The counters are cleared by "ucinewgame",
+/// so they accumulate over all searches since then.
+
+void Search::print_stats() {
+
+#ifdef SEARCH_STATS
+  SearchStats t;
+  t.clear();
+
+  for (Thread* th : Threads)
+  {
+      const SearchStats& s = th->searchStats;
+      t.nodes            += s.nodes;
+      t.qnodes           += s.qnodes;
+      t.betaCutoffs      += s.betaCutoffs;
+      t.firstMoveCutoffs += s.firstMoveCutoffs;
+      t.futilityChild    += s.futilityChild;
+      t.futilityParent   += s.futilityParent;
+      t.nullTries        += s.nullTries;
+      t.nullCutoffs      += s.nullCutoffs;
+      t.nullVerifies     += s.nullVerifies;
+      t.lmrSearches      += s.lmrSearches;
+      t.lmrReSearches    += s.lmrReSearches;
+      t.pawnProbes       += s.pawnProbes;
+      t.pawnHits         += s.pawnHits;
+      t.materialProbes   += s.materialProbes;
+      t.materialHits     += s.materialHits;
+  }
+
+  auto pct = [](uint64_t a, uint64_t b) { return b ? 100.0 * a / b : 0.0; };
+
+  sync_cout << std::fixed << std::setprecision(1)
+            << "info string search nodes " << t.nodes << ", qsearch nodes "
+            << t.qnodes << " (" << pct(t.qnodes, t.nodes + t.qnodes)
+            << "% of tree)";
+
+  uci_out() << "\ninfo string beta cutoffs " << t.betaCutoffs
+            << ", on first move " << pct(t.firstMoveCutoffs, t.betaCutoffs) << '%';
+
+  uci_out() << "\ninfo string null move tries " << t.nullTries
+            << ": cutoff " << pct(t.nullCutoffs, t.nullTries)
+            << "%, verified " << pct(t.nullVerifies, t.nullTries) << '%';
+
+  uci_out() << "\ninfo string futility returns " << t.futilityChild
+            << " (" << pct(t.futilityChild, t.nodes)
+            << "% of nodes), parent-futility skips " << t.futilityParent;
+
+  uci_out() << "\ninfo string LMR searches " << t.lmrSearches
+            << ", re-searched at full depth "
+            << pct(t.lmrReSearches, t.lmrSearches) << '%';
+
+  uci_out() << "\ninfo string pawn hash hits " << pct(t.pawnHits, t.pawnProbes)
+            << "% of " << t.pawnProbes << " probes, material hash hits "
+            << pct(t.materialHits, t.materialProbes) << "% of "
+            << t.materialProbes << " probes";
+
+  uci_out() << std::defaultfloat << sync_endl;
+#else
+  sync_cout << "info string search counters not compiled in, "
+               "build with searchstats=yes" << sync_endl;
+#endif
+}
+
+
 /// Search::perft() is our utility to verify move generation. All the leaf nodes
 /// up to the given depth are generated and counted, and the sum is returned.
 template<bool Root>
@@ -250,6 +380,65 @@ uint64_t Search::perft(Position& pos, Depth depth) {
 template uint64_t Search::perft<true>(Position&, Depth);
 
 
+/// Search::perft_parallel() runs perft with the root moves distributed over
+/// as many worker threads as the "Threads" option configures. Each worker
+/// owns a private copy of the position, like the search threads do, picks
+/// the next unsearched root move from a shared counter and accumulates its
+/// subtree count. The per-move (divide) output is printed at the end in
+/// generation order, matching the single-threaded format.
+
+uint64_t Search::perft_parallel(Position& pos, Depth depth) {
+
+  size_t threadCount = Opts.threads;
+
+  if (threadCount == 1 || depth <= 2 * ONE_PLY)
+      return perft<true>(pos, depth);
+
+  const std::vector<Move> moves = [&pos]() {
+      std::vector<Move> v;
+      for (const auto& m : MoveList<LEGAL>(pos))
+          v.push_back(m);
+      return v;
+  }();
+
+  std::vector<uint64_t> cnt(moves.size(), 0);
+  std::atomic<size_t> nextMove(0);
+  std::vector<std::thread> threads;
+  const std::string fen = pos.fen();
+  const bool chess960 = pos.is_chess960();
+
+  for (size_t idx = 0; idx < std::min(threadCount, moves.size()); ++idx)
+      threads.emplace_back([&, idx]() {
+
+          if (Opts.numaPinning)
+              bind_this_thread(idx);
+
+          Position p;
+          StateInfo rootSt, st;
+          p.set(fen, chess960, &rootSt, Threads.main());
+
+          for (size_t i; (i = nextMove++) < moves.size(); )
+          {
+              p.do_move(moves[i], st, p.gives_check(moves[i], CheckInfo(p)));
+              cnt[i] = perft<false>(p, depth - ONE_PLY);
+              p.undo_move(moves[i]);
+          }
+      });
+
+  for (std::thread& th : threads)
+      th.join();
+
+  uint64_t nodes = 0;
+
+  for (size_t i = 0; i < moves.size(); ++i)
+  {
+      sync_cout << UCI::move(moves[i], chess960) << ": " << cnt[i] << sync_endl;
+      nodes += cnt[i];
+  }
+  return nodes;
+}
+
+
 /// MainThread::search() is called by the main thread when the program receives
 /// the UCI 'go' command. It searches from the root position and outputs the "bestmove".
 
@@ -258,7 +447,7 @@ void MainThread::search() {
   Color us = rootPos.side_to_move();
   Time.init(Limits, us, rootPos.game_ply());
 
-  int contempt = Options["Contempt"] * PawnValueEg / 100; // From centipawns
+  int contempt = Opts.contempt * PawnValueEg / 100; // From centipawns
   DrawValue[ us] = VALUE_DRAW - Value(contempt);
   DrawValue[~us] = VALUE_DRAW + Value(contempt);
 
@@ -271,6 +460,25 @@ void MainThread::search() {
   }
   else
   {
+      // If this position is the predicted child of the previous search, seed
+      // every thread's root move ordering and scores from what that search
+      // already knew, before the helper threads pick up their root moves.
+      if (rootPos.key() == Continuation.key && Continuation.move != MOVE_NONE)
+      {
+          for (Thread* th : Threads)
+          {
+              Search::RootMoves& rm = th->rootMoves;
+              auto it = std::find(rm.begin(), rm.end(), Continuation.move);
+
+              if (it != rm.end())
+              {
+                  std::rotate(rm.begin(), it, it + 1);
+                  rm[0].score = rm[0].previousScore = Continuation.score;
+              }
+          }
+          previousScore = Continuation.score;
+      }
+
       for (Thread* th : Threads)
           if (th != this)
               th->start_searching();
@@ -305,9 +513,9 @@ void MainThread::search() {
   // Check if there are threads with a better score than main thread
   Thread* bestThread = this;
   if (   !this->easyMovePlayed
-      &&  Options["MultiPV"] == 1
+      &&  Opts.multiPV == 1
       && !Limits.depth
-      && !Skill(Options["Skill Level"]).enabled()
+      && !Skill(Opts.skillLevel).enabled()
       &&  rootMoves[0].pv[0] != MOVE_NONE)
   {
       for (Thread* th : Threads)
@@ -318,6 +526,22 @@ void MainThread::search() {
 
   previousScore = bestThread->rootMoves[0].score;
 
+  // Remember what this search learned about the position after our best
+  // move, so that the next "go" on that position can start from it. A
+  // scratch position is used so rootPos' node counter stays untouched.
+  if (bestThread->rootMoves[0].pv[0] != MOVE_NONE)
+  {
+      const RootMove& rm = bestThread->rootMoves[0];
+      Position p;
+      StateInfo st[2];
+
+      p.set(rootPos.fen(), rootPos.is_chess960(), &st[0], this);
+      p.do_move(rm.pv[0], st[1], p.gives_check(rm.pv[0], CheckInfo(p)));
+      Continuation.key = p.key();
+      Continuation.move = rm.pv.size() > 1 ? rm.pv[1] : MOVE_NONE;
+      Continuation.score = -rm.score;
+  }
+
   // Send new PV when needed
   if (bestThread != this)
       sync_cout << UCI::pv(bestThread->rootPos, bestThread->completedDepth, -VALUE_INFINITE, VALUE_INFINITE) << sync_endl;
@@ -325,9 +549,9 @@ void MainThread::search() {
   sync_cout << "bestmove " << UCI::move(bestThread->rootMoves[0].pv[0], rootPos.is_chess960());
 
   if (bestThread->rootMoves[0].pv.size() > 1 || bestThread->rootMoves[0].extract_ponder_from_tt(rootPos))
-      std::cout << " ponder " << UCI::move(bestThread->rootMoves[0].pv[1], rootPos.is_chess960());
+      uci_out() << " ponder " << UCI::move(bestThread->rootMoves[0].pv[1], rootPos.is_chess960());
 
-  std::cout << sync_endl;
+  uci_out() << sync_endl;
 }
 
 
@@ -357,8 +581,8 @@ void Thread::search() {
       TT.new_search();
   }
 
-  size_t multiPV = Options["MultiPV"];
-  Skill skill(Options["Skill Level"]);
+  size_t multiPV = Opts.multiPV;
+  Skill skill(Opts.skillLevel);
 
   // When playing with strength handicap enable MultiPV search that we will
   // use behind the scenes to retrieve a set of possible moves.
@@ -370,15 +594,6 @@ void Thread::search() {
   // Iterative deepening loop until requested to stop or the target depth is reached.
   while (++rootDepth < DEPTH_MAX && !Signals.stop && (!Limits.depth || Threads.main()->rootDepth <= Limits.depth))
   {
-      // Set up the new depths for the helper threads skipping on average every
-      // 2nd ply (using a half-density matrix).
-      if (!mainThread)
-      {
-          const Row& row = HalfDensity[(idx - 1) % HalfDensitySize];
-          if (row[(rootDepth + rootPos.game_ply()) % row.size()])
-             continue;
-      }
-
       // Age out PV variability metric
       if (mainThread)
           mainThread->bestMoveChanges *= 0.505, mainThread->failedLow = false;
@@ -388,8 +603,17 @@ void Thread::search() {
       for (RootMove& rm : rootMoves)
           rm.previousScore = rm.score;
 
+      // In MultiPV mode spread the helper threads over the PV lines, so that
+      // distinct lines are deepened concurrently through the shared TT
+      // instead of every thread grinding the first line while the remaining
+      // lines wait. Each helper starts its MultiPV loop at a different line;
+      // the main thread still searches every line and reports the merged
+      // result, but re-searches of lines pre-searched by helpers come almost
+      // for free from the hash table.
+      size_t pvFirst = !mainThread && multiPV > 1 ? (idx - 1) % multiPV : 0;
+
       // MultiPV loop. We perform a full root search for each PV line
-      for (PVIdx = 0; PVIdx < multiPV && !Signals.stop; ++PVIdx)
+      for (PVIdx = pvFirst; PVIdx < multiPV && !Signals.stop; ++PVIdx)
       {
           // Reset aspiration window starting size
           if (rootDepth >= 5 * ONE_PLY)
@@ -567,6 +791,10 @@ namespace {
     // Step 1. Initialize node
     Thread* thisThread = pos.this_thread();
     inCheck = pos.checkers();
+
+#ifdef SEARCH_STATS
+    ++thisThread->searchStats.nodes;
+#endif
     moveCount = quietCount =  ss->moveCount = 0;
     bestValue = -VALUE_INFINITE;
     ss->ply = (ss-1)->ply + 1;
@@ -652,7 +880,24 @@ namespace {
             &&  pos.rule50_count() == 0
             && !pos.can_castle(ANY_CASTLING))
         {
-            int found, v = Tablebases::probe_wdl(pos, &found);
+            // Look up the per-thread WDL cache first: a revisit is answered
+            // without running the tablebase decompression code at all.
+            Tablebases::WDLEntry* we = thisThread->wdlCache[posKey];
+            int found, v;
+
+            if (we->key == posKey)
+            {
+                found = we->found;
+                v = we->wdl;
+            }
+            else
+            {
+                v = Tablebases::probe_wdl(pos, &found);
+
+                we->key = posKey;
+                we->wdl = v;
+                we->found = found;
+            }
 
             if (found)
             {
@@ -726,7 +971,12 @@ namespace {
         &&  eval - futility_margin(depth) >= beta
         &&  eval < VALUE_KNOWN_WIN  // Do not return unproven wins
         &&  pos.non_pawn_material(pos.side_to_move()))
+    {
+#ifdef SEARCH_STATS
+        ++thisThread->searchStats.futilityChild;
+#endif
         return eval - futility_margin(depth);
+    }
 
     // Step 8. Null move search with verification search (is omitted in PV nodes)
     if (   !PvNode
@@ -739,6 +989,10 @@ namespace {
 
         assert(eval - beta >= 0);
 
+#ifdef SEARCH_STATS
+        ++thisThread->searchStats.nullTries;
+#endif
+
         // Null move dynamic reduction based on depth and value
         Depth R = ((823 + 67 * depth) / 256 + std::min((eval - beta) / PawnValueMg, 3)) * ONE_PLY;
 
@@ -755,9 +1009,17 @@ namespace {
             if (nullValue >= VALUE_MATE_IN_MAX_PLY)
                 nullValue = beta;
 
+#ifdef SEARCH_STATS
+            ++thisThread->searchStats.nullCutoffs;
+#endif
+
             if (depth < 12 * ONE_PLY && abs(beta) < VALUE_KNOWN_WIN)
                 return nullValue;
 
+#ifdef SEARCH_STATS
+            ++thisThread->searchStats.nullVerifies;
+#endif
+
             // Do verification search at high depths
             ss->skipEarlyPruning = true;
             Value v = depth-R < ONE_PLY ? qsearch<NonPV, false>(pos, ss, beta-1, beta, DEPTH_ZERO)
@@ -791,7 +1053,7 @@ namespace {
             if (pos.legal(move, ci.pinned))
             {
                 ss->currentMove = move;
-                ss->counterMoves = &CounterMoveHistory[pos.moved_piece(move)][to_sq(move)];
+                ss->counterMoves = cm_history(pos.moved_piece(move), to_sq(move));
                 pos.do_move(move, st, pos.gives_check(move, ci));
                 value = -search<NonPV>(pos, ss+1, -rbeta, -rbeta+1, rdepth, !cutNode);
                 pos.undo_move(move);
@@ -820,6 +1082,9 @@ moves_loop: // When in check search starts from here
     const CounterMoveStats* fmh  = (ss-2)->counterMoves;
     const CounterMoveStats* fmh2 = (ss-4)->counterMoves;
 
+    // Mark this node as being searched
+    ThreadHolding th(thisThread, posKey, ss->ply);
+
     MovePicker mp(pos, ttMove, depth, ss);
     CheckInfo ci(pos);
     value = bestValue; // Workaround a bogus 'uninitialized' warning under gcc
@@ -855,9 +1120,14 @@ moves_loop: // When in check search starts from here
       ss->moveCount = ++moveCount;
 
       if (rootNode && thisThread == Threads.main() && Time.elapsed() > 3000)
-          sync_cout << "info depth " << depth / ONE_PLY
-                    << " currmove " << UCI::move(move, pos.is_chess960())
-                    << " currmovenumber " << moveCount + thisThread->PVIdx << sync_endl;
+      {
+          UCI::LineBuffer<128> line;
+          line.add("info depth ")      .add(depth / ONE_PLY)
+              .add(" currmove ")       .add(move, pos.is_chess960())
+              .add(" currmovenumber ") .add(int64_t(moveCount + thisThread->PVIdx));
+
+          sync_cout << line.c_str() << sync_endl;
+      }
 
       if (PvNode)
           (ss+1)->pv = nullptr;
@@ -876,7 +1146,7 @@ moves_loop: // When in check search starts from here
       // Step 12. Extend checks
       if (    givesCheck
           && !moveCountPruning
-          &&  pos.see_sign(move) >= VALUE_ZERO)
+          &&  pos.see_ge(move))
           extension = ONE_PLY;
 
       // Singular extension search. If all moves but one fail low on a search of
@@ -928,7 +1198,12 @@ moves_loop: // When in check search starts from here
           // Futility pruning: parent node
           if (   predictedDepth < 7 * ONE_PLY
               && ss->staticEval + 256 + 200 * predictedDepth / ONE_PLY <= alpha)
+          {
+#ifdef SEARCH_STATS
+              ++thisThread->searchStats.futilityParent;
+#endif
               continue;
+          }
 
           // Prune moves with negative SEE at low depths and below a decreasing
           // threshold at higher depths.
@@ -937,14 +1212,23 @@ moves_loop: // When in check search starts from here
               Value see_v = predictedDepth < 4 * ONE_PLY ? VALUE_ZERO
                             : -PawnValueMg * 2 * int(predictedDepth - 3 * ONE_PLY);
 
-              if (pos.see_sign(move) < see_v)
+              if (!pos.see_ge(move, see_v))
                   continue;
           }
       }
 
-      // Speculative prefetch as early as possible
+      // Speculative prefetch as early as possible, so the memory latency
+      // overlaps with the legality check and the making of the move. Pawn
+      // and material entries are touched only when the move changes their
+      // key, so most quiet moves prefetch just the TT cluster.
       prefetch(TT.first_entry(pos.key_after(move)));
 
+      if (type_of(moved_piece) == PAWN || type_of(pos.piece_on(to_sq(move))) == PAWN)
+          prefetch(thisThread->pawnsTable[pos.pawn_key_after(move)]);
+
+      if (pos.capture(move))
+          prefetch(thisThread->materialTable[pos.material_key_after(move)]);
+
       // Check for legality just before making the move
       if (!rootNode && !pos.legal(move, ci.pinned))
       {
@@ -953,7 +1237,7 @@ moves_loop: // When in check search starts from here
       }
 
       ss->currentMove = move;
-      ss->counterMoves = &CounterMoveHistory[moved_piece][to_sq(move)];
+      ss->counterMoves = cm_history(moved_piece, to_sq(move));
 
       // Step 14. Make the move
       pos.do_move(move, st, givesCheck);
@@ -971,17 +1255,21 @@ moves_loop: // When in check search starts from here
                      +    (fmh2 ? (*fmh2)[moved_piece][to_sq(move)] : VALUE_ZERO)
                      +    thisThread->fromTo.get(~pos.side_to_move(), move);
 
+          // Increase reduction if another thread is searching this node, so
+          // that we pick up a different sibling instead
+          if (th.marked())
+              r += ONE_PLY;
+
           // Increase reduction for cut nodes
           if (cutNode)
               r += 2 * ONE_PLY;
 
           // Decrease reduction for moves that escape a capture. Filter out
           // castling moves, because they are coded as "king captures rook" and
-          // hence break make_move(). Also use see() instead of see_sign(),
-          // because the destination square is empty.
+          // hence break make_move().
           else if (   type_of(move) == NORMAL
                    && type_of(pos.piece_on(to_sq(move))) != PAWN
-                   && pos.see(make_move(to_sq(move), from_sq(move))) < VALUE_ZERO)
+                   && !pos.see_ge(make_move(to_sq(move), from_sq(move))))
               r -= 2 * ONE_PLY;
 
           // Decrease/increase reduction for moves with a good/bad history
@@ -993,6 +1281,11 @@ moves_loop: // When in check search starts from here
           value = -search<NonPV>(pos, ss+1, -(alpha+1), -alpha, d, true);
 
           doFullDepthSearch = (value > alpha && r != DEPTH_ZERO);
+
+#ifdef SEARCH_STATS
+          ++thisThread->searchStats.lmrSearches;
+          thisThread->searchStats.lmrReSearches += doFullDepthSearch;
+#endif
       }
       else
           doFullDepthSearch = !PvNode || moveCount > 1;
@@ -1082,6 +1375,11 @@ moves_loop: // When in check search starts from here
               else
               {
                   assert(value >= beta); // Fail high
+
+#ifdef SEARCH_STATS
+                  ++thisThread->searchStats.betaCutoffs;
+                  thisThread->searchStats.firstMoveCutoffs += moveCount == 1;
+#endif
                   break;
               }
           }
@@ -1173,6 +1471,10 @@ moves_loop: // When in check search starts from here
     ss->currentMove = bestMove = MOVE_NONE;
     ss->ply = (ss-1)->ply + 1;
 
+#ifdef SEARCH_STATS
+    ++pos.this_thread()->searchStats.qnodes;
+#endif
+
     // Check for an instant draw or if the maximum ply has been reached
     if (pos.is_draw() || ss->ply >= MAX_PLY)
         return ss->ply >= MAX_PLY && !InCheck ? evaluate(pos)
@@ -1275,7 +1577,7 @@ moves_loop: // When in check search starts from here
               continue;
           }
 
-          if (futilityBase <= alpha && pos.see(move) <= VALUE_ZERO)
+          if (futilityBase <= alpha && !pos.see_ge(move, VALUE_ZERO + 1))
           {
               bestValue = std::max(bestValue, futilityBase);
               continue;
@@ -1290,12 +1592,16 @@ moves_loop: // When in check search starts from here
       // Don't search moves with negative SEE values
       if (  (!InCheck || evasionPrunable)
           &&  type_of(move) != PROMOTION
-          &&  pos.see_sign(move) < VALUE_ZERO)
+          && !pos.see_ge(move))
           continue;
 
-      // Speculative prefetch as early as possible
+      // Speculative prefetch as early as possible. Nearly every move here
+      // is a capture, so also line up the child's material entry.
       prefetch(TT.first_entry(pos.key_after(move)));
 
+      if (pos.capture(move))
+          prefetch(pos.this_thread()->materialTable[pos.material_key_after(move)]);
+
       // Check for legality just before making the move
       if (!pos.legal(move, ci.pinned))
           continue;
@@ -1518,16 +1824,21 @@ moves_loop: // When in check search starts from here
 
 /// UCI::pv() formats PV information according to the UCI protocol. UCI requires
 /// that all (if any) unsearched PV lines are sent using a previous search score.
+/// The lines are built in a reused fixed buffer so that emitting a PV does not
+/// allocate on the search-critical main thread.
+
+const char* UCI::pv(const Position& pos, Depth depth, Value alpha, Value beta) {
 
-string UCI::pv(const Position& pos, Depth depth, Value alpha, Value beta) {
+  static thread_local LineBuffer<1 << 20> line;
 
-  std::stringstream ss;
   int elapsed = Time.elapsed() + 1;
   const RootMoves& rootMoves = pos.this_thread()->rootMoves;
   size_t PVIdx = pos.this_thread()->PVIdx;
-  size_t multiPV = std::min((size_t)Options["MultiPV"], rootMoves.size());
+  size_t multiPV = std::min(Opts.multiPV, rootMoves.size());
   uint64_t nodes_searched = Threads.nodes_searched();
 
+  line.clear();
+
   for (size_t i = 0; i < multiPV; ++i)
   {
       bool updated = (i <= PVIdx);
@@ -1541,33 +1852,32 @@ string UCI::pv(const Position& pos, Depth depth, Value alpha, Value beta) {
       bool tb = TB::RootInTB && abs(v) < VALUE_MATE - MAX_PLY;
       v = tb ? TB::Score : v;
 
-      if (ss.rdbuf()->in_avail()) // Not at first line
-          ss << "\n";
+      if (!line.empty()) // Not at first line
+          line.add("\n");
 
-      ss << "info"
-         << " depth "    << d / ONE_PLY
-         << " seldepth " << pos.this_thread()->maxPly
-         << " multipv "  << i + 1
-         << " score "    << UCI::value(v);
+      line.add("info depth ").add(d / ONE_PLY)
+          .add(" seldepth ")  .add(pos.this_thread()->maxPly)
+          .add(" multipv ")   .add(int64_t(i + 1))
+          .add(" score ")     .add(v);
 
       if (!tb && i == PVIdx)
-          ss << (v >= beta ? " lowerbound" : v <= alpha ? " upperbound" : "");
+          line.add(v >= beta ? " lowerbound" : v <= alpha ? " upperbound" : "");
 
-      ss << " nodes "    << nodes_searched
-         << " nps "      << nodes_searched * 1000 / elapsed;
+      line.add(" nodes ").add(int64_t(nodes_searched))
+          .add(" nps ")  .add(int64_t(nodes_searched * 1000 / elapsed));
 
       if (elapsed > 1000) // Earlier makes little sense
-          ss << " hashfull " << TT.hashfull();
+          line.add(" hashfull ").add(TT.hashfull());
 
-      ss << " tbhits "   << TB::Hits
-         << " time "     << elapsed
-         << " pv";
+      line.add(" tbhits ").add(TB::Hits)
+          .add(" time ")  .add(elapsed)
+          .add(" pv");
 
       for (Move m : rootMoves[i].pv)
-          ss << " " << UCI::move(m, pos.is_chess960());
+          line.add(" ").add(m, pos.is_chess960());
   }
 
-  return ss.str();
+  return line.c_str();
 }
 
 
@@ -1583,6 +1893,9 @@ bool RootMove::extract_ponder_from_tt(Position& pos)
 
     assert(pv.size() == 1);
 
+    if (pv[0] == MOVE_NONE) // Mated or stalemated root, nothing to ponder on
+        return false;
+
     pos.do_move(pv[0], st, pos.gives_check(pv[0], CheckInfo(pos)));
     TTEntry* tte = TT.probe(pos.key(), ttHit);
 
@@ -1601,9 +1914,9 @@ void Tablebases::filter_root_moves(Position& pos, Search::RootMoves& rootMoves)
 
     Hits = 0;
     RootInTB = false;
-    UseRule50 = Options["Syzygy50MoveRule"];
-    ProbeDepth = Options["SyzygyProbeDepth"] * ONE_PLY;
-    Cardinality = Options["SyzygyProbeLimit"];
+    UseRule50 = Opts.syzygy50MoveRule;
+    ProbeDepth = Opts.syzygyProbeDepth * ONE_PLY;
+    Cardinality = Opts.syzygyProbeLimit;
 
     // Skip TB probing when no TB found: !TBLargest -> !TB::Cardinality
     if (Cardinality > MaxCardinality)
@@ -1642,3 +1955,57 @@ void Tablebases::filter_root_moves(Position& pos, Search::RootMoves& rootMoves)
                                                 :  VALUE_DRAW;
     }
 }
+
+namespace {
+
+  std::thread TBWarmThread; // Runs the speculative root probe, if any
+
+}
+
+/// Tablebases::warm_root_moves() machinery: on a cold page cache the DTZ
+/// probe in filter_root_moves() can stall the search start for hundreds of
+/// milliseconds while table files are demand-paged in. Since the root
+/// position is already known when the "position" command arrives, we run a
+/// throwaway root probe on a private copy of the position in a background
+/// thread during the opponent's thinking time. By the time "go" arrives the
+/// relevant pages are resident and the real probe is nearly free.
+
+void Tablebases::warm_root_async(const Position& pos) {
+
+    warm_root_wait(); // At most one speculative probe in flight
+
+    if (   !MaxCardinality
+        ||  popcount(pos.pieces()) > MaxCardinality
+        ||  popcount(pos.pieces()) > Opts.syzygyProbeLimit
+        ||  pos.can_castle(ANY_CASTLING))
+        return;
+
+    const std::string fen = pos.fen();
+    const bool chess960 = pos.is_chess960();
+
+    TBWarmThread = std::thread([fen, chess960]() {
+
+        Position p;
+        StateInfo st;
+        p.set(fen, chess960, &st, Threads.main());
+
+        Search::RootMoves rootMoves;
+        for (const auto& m : MoveList<LEGAL>(p))
+            rootMoves.push_back(Search::RootMove(m));
+
+        Value score;
+        if (!root_probe(p, rootMoves, score))
+            root_probe_wdl(p, rootMoves, score);
+    });
+}
+
+
+/// Tablebases::warm_root_wait() joins a pending speculative probe. Called
+/// before the real root probe and before program exit, so the background
+/// thread never races against them.
+
+void Tablebases::warm_root_wait() {
+
+    if (TBWarmThread.joinable())
+        TBWarmThread.join();
+}
@@ -96,12 +96,43 @@ struct SignalsType {
   std::atomic_bool stop, stopOnPonderhit;
 };
 
+#ifdef SEARCH_STATS
+
+/// SearchStats hold per-thread counters attached to the main decision points
+/// of search() and qsearch(), used offline to tune pruning margins and move
+/// ordering for a given time control. Each Thread owns one instance, so the
+/// counters are plain integers with no synchronization. Compiled in only
+/// with searchstats=yes, see the "searchstats" command.
+
+struct SearchStats {
+  uint64_t nodes;            // search() nodes
+  uint64_t qnodes;           // qsearch() nodes
+  uint64_t betaCutoffs;      // Nodes failing high in the moves loop
+  uint64_t firstMoveCutoffs; // ...of which on the first move
+  uint64_t futilityChild;    // Step 7 stand-pat futility returns
+  uint64_t futilityParent;   // Moves skipped by parent futility pruning
+  uint64_t nullTries;        // Null move searches started
+  uint64_t nullCutoffs;      // ...that failed high
+  uint64_t nullVerifies;     // ...that needed a verification search
+  uint64_t lmrSearches;      // Reduced depth (LMR) searches
+  uint64_t lmrReSearches;    // ...that failed high and went to full depth
+  uint64_t pawnProbes;       // Pawns::probe() calls
+  uint64_t pawnHits;         // ...answered without recomputing
+  uint64_t materialProbes;   // Material::probe() calls
+  uint64_t materialHits;     // ...answered without recomputing
+
+  void clear() { *this = SearchStats(); }
+};
+#endif
+
 extern SignalsType Signals;
 extern LimitsType Limits;
 
 void init();
 void clear();
+void print_stats();
 template<bool Root = true> uint64_t perft(Position& pos, Depth depth);
+uint64_t perft_parallel(Position& pos, Depth depth);
 
 } // namespace Search
 
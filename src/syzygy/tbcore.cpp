@@ -35,8 +35,6 @@
 #define TB_WPAWN TB_PAWN
 #define TB_BPAWN (TB_PAWN | 8)
 
-static LOCK_T TB_mutex;
-
 static bool initialized = false;
 static int num_paths = 0;
 static char *path_string = NULL;
@@ -57,6 +55,34 @@ static uint64 calc_key_from_pcs(int *pcs, int mirror);
 static void free_wdl_entry(struct TBEntry *entry);
 static void free_dtz_entry(struct TBEntry *entry);
 
+// Direct-mapped, lock-free cache of decompressed values keyed by
+// (PairsData, index). Hot endgame probes hit the same few indices over and
+// over, and a hit skips decompress_pairs() entirely. Entries are validated
+// with the xor trick used by the main hash table, so torn concurrent
+// updates are detected and treated as misses.
+#define DCACHE_BITS 16
+
+struct DCacheEntry {
+  uint64 key;
+  uint64 val; // key ^ value, so that a mismatched pair is rejected
+};
+
+static struct DCacheEntry DCache[1 << DCACHE_BITS];
+
+static void dcache_clear(void)
+{
+  memset(DCache, 0, sizeof(DCache));
+}
+
+static uint64 dcache_key(struct PairsData *d, uint64 idx)
+{
+  uint64 k = (uint64)(uintptr_t)d + idx * 0x9E3779B97F4A7C15ULL;
+  k ^= k >> 29;
+  k *= 0xBF58476D1CE4E5B9ULL;
+  k ^= k >> 32;
+  return k | 1; // Never 0, so an empty slot cannot match
+}
+
 static FD open_tb(const char *str, const char *suffix)
 {
   int i;
@@ -218,6 +244,7 @@ static void init_tb(char *str)
   }
   entry->key = key;
   entry->ready = 0;
+  LOCK_INIT(entry->lock);
   entry->num = 0;
   for (i = 0; i < 16; i++)
     entry->num += (ubyte)pcs[i];
@@ -298,7 +325,7 @@ void Tablebases::init(const std::string& path)
     while (path_string[j]) j++;
   }
 
-  LOCK_INIT(TB_mutex);
+  dcache_clear();
 
   TBnum_piece = TBnum_pawn = 0;
   MaxCardinality = 0;
@@ -1360,6 +1387,10 @@ static void free_wdl_entry(struct TBEntry *entry)
 
 static void free_dtz_entry(struct TBEntry *entry)
 {
+  // The freed PairsData addresses may be reused by a later table, so drop
+  // any cached values that could alias them.
+  dcache_clear();
+
   unmap_file(entry->data, entry->mapping);
   if (!entry->has_pawns) {
     struct DTZEntry_piece *ptr = (struct DTZEntry_piece *)entry;
@@ -78,6 +78,7 @@ struct TBEntry {
   ubyte num;
   ubyte symmetric;
   ubyte has_pawns;
+  LOCK_T lock;
 }
 #ifndef _WIN32
 __attribute__((__may_alias__))
@@ -92,6 +93,7 @@ struct TBEntry_piece {
   ubyte num;
   ubyte symmetric;
   ubyte has_pawns;
+  LOCK_T lock;
   ubyte enc_type;
   struct PairsData *precomp[2];
   int factor[2][TBPIECES];
@@ -107,6 +109,7 @@ struct TBEntry_pawn {
   ubyte num;
   ubyte symmetric;
   ubyte has_pawns;
+  LOCK_T lock;
   ubyte pawns[2];
   struct {
     struct PairsData *precomp[2];
@@ -124,6 +127,7 @@ struct DTZEntry_piece {
   ubyte num;
   ubyte symmetric;
   ubyte has_pawns;
+  LOCK_T lock;
   ubyte enc_type;
   struct PairsData *precomp;
   int factor[TBPIECES];
@@ -142,6 +146,7 @@ struct DTZEntry_pawn {
   ubyte num;
   ubyte symmetric;
   ubyte has_pawns;
+  LOCK_T lock;
   ubyte pawns[2];
   struct {
     struct PairsData *precomp;
@@ -104,8 +104,20 @@ bool is_little_endian() {
 static ubyte decompress_pairs(struct PairsData *d, uint64 idx)
 {
   static const bool isLittleEndian = is_little_endian();
-  return isLittleEndian ? decompress_pairs<true >(d, idx)
-                        : decompress_pairs<false>(d, idx);
+
+  uint64 key = dcache_key(d, idx);
+  struct DCacheEntry *e = &DCache[key & ((1 << DCACHE_BITS) - 1)];
+  uint64 k = e->key, v = e->val;
+
+  if (k == key && (v ^ key) < 256)
+    return (ubyte)(v ^ key);
+
+  ubyte res = isLittleEndian ? decompress_pairs<true >(d, idx)
+                             : decompress_pairs<false>(d, idx);
+  e->key = key;
+  e->val = key ^ res;
+
+  return res;
 }
 
 // probe_wdl_table and probe_dtz_table require similar adaptations.
@@ -136,14 +148,16 @@ static int probe_wdl_table(Position& pos, int *success)
 
   ptr = ptr2[i].ptr;
   if (!ptr->ready) {
-    LOCK(TB_mutex);
+    // Lazy initialization is guarded by a per-table lock, so threads
+    // probing different tables do not serialize on a single global mutex.
+    LOCK(ptr->lock);
     if (!ptr->ready) {
       char str[16];
       prt_str(pos, str, ptr->key != key);
       if (!init_table_wdl(ptr, str)) {
         ptr2[i].key = 0ULL;
         *success = 0;
-        UNLOCK(TB_mutex);
+        UNLOCK(ptr->lock);
         return 0;
       }
       // Memory barrier to ensure ptr->ready = 1 is not reordered.
@@ -154,7 +168,7 @@ static int probe_wdl_table(Position& pos, int *success)
 #endif
       ptr->ready = 1;
     }
-    UNLOCK(TB_mutex);
+    UNLOCK(ptr->lock);
   }
 
   int bside, mirror, cmirror;
@@ -1,18 +1,33 @@
 #ifndef TBPROBE_H
 #define TBPROBE_H
 
+#include "../misc.h"
 #include "../search.h"
 
 namespace Tablebases {
 
 extern int MaxCardinality;
 
+// WDLEntry caches the result of a probe_wdl() call for one position, so that
+// revisits are answered by a hash lookup instead of the decompression code.
+// Each thread owns a WDLCache, see the Thread class.
+
+struct WDLEntry {
+  Key     key;
+  int32_t wdl;
+  int32_t found;
+};
+
+typedef HashTable<WDLEntry, 8192> WDLCache;
+
 void init(const std::string& path);
 int probe_wdl(Position& pos, int *success);
 int probe_dtz(Position& pos, int *success);
 bool root_probe(Position& pos, Search::RootMoves& rootMoves, Value& score);
 bool root_probe_wdl(Position& pos, Search::RootMoves& rootMoves, Value& score);
 void filter_root_moves(Position& pos, Search::RootMoves& rootMoves);
+void warm_root_async(const Position& pos);
+void warm_root_wait();
 
 }
 
@@ -36,10 +36,16 @@ Thread::Thread() {
 
   resetCalls = exit = false;
   maxPly = callsCnt = 0;
-  history.clear();
-  counterMoves.clear();
   idx = Threads.size(); // Start from 0
 
+  // Threads spawned after startup must honor the configured table sizes
+  pawnsTable.resize(Opts.pawnHashSize);
+  materialTable.resize(Opts.materialHashSize);
+
+#ifdef SEARCH_STATS
+  searchStats.clear(); // Not reached by Search::clear() before first use
+#endif
+
   std::unique_lock<Mutex> lk(mutex);
   searching = true;
   nativeThread = std::thread(&Thread::idle_loop, this);
@@ -53,7 +59,7 @@ Thread::~Thread() {
 
   mutex.lock();
   exit = true;
-  sleepCondition.notify_one();
+  sleepCondition.notify_all();
   mutex.unlock();
   nativeThread.join();
 }
@@ -95,20 +101,41 @@ void Thread::start_searching(bool resume) {
 
 void Thread::idle_loop() {
 
+  // With "NUMA Pinning" enabled pin ourselves to a fixed CPU, spreading the
+  // pool round-robin across the NUMA nodes, before the first touch of the
+  // history tables below so that their pages end up on the local node. The
+  // binding happens at thread creation, so "NUMA Pinning" should be set
+  // before "Threads" to take effect for the whole pool.
+  if (Opts.numaPinning)
+      bind_this_thread(idx);
+
+  history.clear();
+  counterMoves.clear();
+  fromTo.clear();
+
   while (!exit)
   {
       std::unique_lock<Mutex> lk(mutex);
 
       searching = false;
+      sleepCondition.notify_all(); // Wake up any thread waiting for us to finish
+
+      lk.unlock();
 
-      while (!searching && !exit)
+      // In fast games the next search follows within microseconds, so spin
+      // for a bounded while before paying for a kernel-level park and wake
+      // up. While we spin, start_searching() hands work over with a plain
+      // store to 'searching' and an uncontended notify.
+      for (int i = 0; i < 100000 && !searching && !exit; ++i)
+      {}
+
+      if (!searching && !exit)
       {
-          sleepCondition.notify_one(); // Wake up any waiting thread
-          sleepCondition.wait(lk);
+          lk.lock();
+          sleepCondition.wait(lk, [&]{ return searching || exit; });
+          lk.unlock();
       }
 
-      lk.unlock();
-
       if (!exit)
           search();
   }
@@ -133,6 +160,8 @@ void ThreadPool::init() {
 
 void ThreadPool::exit() {
 
+  Tablebases::warm_root_wait();
+
   while (size())
       delete back(), pop_back();
 }
@@ -144,7 +173,7 @@ void ThreadPool::exit() {
 
 void ThreadPool::read_uci_options() {
 
-  size_t requested = Options["Threads"];
+  size_t requested = Opts.threads;
 
   assert(requested > 0);
 
@@ -167,6 +196,21 @@ int64_t ThreadPool::nodes_searched() {
 }
 
 
+/// ThreadPool::fresh_states() returns a state list holding a single StateInfo,
+/// ready for Position::set(). To avoid one heap allocation and free per "go",
+/// the list replaced by the previous start_thinking() is recycled when available
+/// instead of allocating a new one.
+
+StateListPtr ThreadPool::fresh_states() {
+
+  StateListPtr states =  spareStates.get()
+                       ? std::move(spareStates)
+                       : StateListPtr(new std::deque<StateInfo>());
+  states->resize(1);
+  return states;
+}
+
+
 /// ThreadPool::start_thinking() wakes up the main thread sleeping in idle_loop()
 /// and starts a new search, then returns immediately.
 
@@ -177,21 +221,44 @@ void ThreadPool::start_thinking(Position& pos, StateListPtr& states,
 
   Search::Signals.stopOnPonderhit = Search::Signals.stop = false;
   Search::Limits = limits;
-  Search::RootMoves rootMoves;
+  rootMoves.clear(); // Reuse the storage acquired by previous searches
 
   for (const auto& m : MoveList<LEGAL>(pos))
       if (   limits.searchmoves.empty()
           || std::count(limits.searchmoves.begin(), limits.searchmoves.end(), m))
           rootMoves.push_back(Search::RootMove(m));
 
+  Tablebases::warm_root_wait(); // A speculative probe may still be running
   Tablebases::filter_root_moves(pos, rootMoves);
 
+  // With "Cluster Count" > 1 this process is one worker of a cluster: it
+  // searches only a deterministic slice of the root moves, identified by
+  // "Cluster Rank". An external coordinator runs one worker per machine on
+  // the same position, merges the returned scores, and can share deep hash
+  // entries between the workers through the ttsave/ttload commands.
+  size_t clusterCount = Opts.clusterCount;
+
+  if (clusterCount > 1)
+  {
+      Search::RootMoves slice;
+
+      for (size_t i = Opts.clusterRank % clusterCount;
+           i < rootMoves.size(); i += clusterCount)
+          slice.push_back(rootMoves[i]);
+
+      if (!slice.empty()) // A rank beyond the move count searches everything
+          rootMoves = slice;
+  }
+
   // After ownership transfer 'states' becomes empty, so if we stop the search
   // and call 'go' again without setting a new position states.get() == NULL.
   assert(states.get() || setupStates.get());
 
   if (states.get())
-      setupStates = std::move(states); // Ownership transfer, states is now empty
+  {
+      spareStates = std::move(setupStates); // Keep the old list for recycling
+      setupStates = std::move(states);      // Ownership transfer, states is now empty
+  }
 
   StateInfo tmp = setupStates->back();
 
@@ -28,12 +28,14 @@
 #include <thread>
 #include <vector>
 
+#include "evaluate.h"
 #include "material.h"
 #include "movepick.h"
 #include "pawns.h"
 #include "position.h"
 #include "search.h"
 #include "thread_win32.h"
+#include "syzygy/tbprobe.h"
 
 
 /// Thread struct keeps together all the thread-related stuff. We also use
@@ -46,7 +48,7 @@ class Thread {
   std::thread nativeThread;
   Mutex mutex;
   ConditionVariable sleepCondition;
-  bool exit, searching;
+  std::atomic_bool exit, searching;
 
 public:
   Thread();
@@ -59,6 +61,8 @@ public:
 
   Pawns::Table pawnsTable;
   Material::Table materialTable;
+  Eval::Table evalTable;
+  Tablebases::WDLCache wdlCache;
   Endgames endgames;
   size_t idx, PVIdx;
   int maxPly, callsCnt;
@@ -71,6 +75,10 @@ public:
   FromToStats fromTo;
   Depth completedDepth;
   std::atomic_bool resetCalls;
+
+#ifdef SEARCH_STATS
+  Search::SearchStats searchStats;
+#endif
 };
 
 
@@ -98,9 +106,12 @@ struct ThreadPool : public std::vector<Thread*> {
   void start_thinking(Position&, StateListPtr&, const Search::LimitsType&);
   void read_uci_options();
   int64_t nodes_searched();
+  StateListPtr fresh_states();
 
 private:
   StateListPtr setupStates;
+  StateListPtr spareStates;     // Recycled by start_thinking() for reuse
+  Search::RootMoves rootMoves;  // Reused between searches to keep its storage
 };
 
 extern ThreadPool Threads;
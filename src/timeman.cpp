@@ -83,10 +83,10 @@ namespace {
 
 void TimeManagement::init(Search::LimitsType& limits, Color us, int ply)
 {
-  int minThinkingTime = Options["Minimum Thinking Time"];
-  int moveOverhead    = Options["Move Overhead"];
-  int slowMover       = Options["Slow Mover"];
-  int npmsec          = Options["nodestime"];
+  int minThinkingTime = Opts.minThinkingTime;
+  int moveOverhead    = Opts.moveOverhead;
+  int slowMover       = Opts.slowMover;
+  int npmsec          = Opts.npmsec;
 
   // If we have to play in 'nodes as time' mode, then convert from time
   // to nodes, and use resulting values in time management formulas.
@@ -127,6 +127,6 @@ void TimeManagement::init(Search::LimitsType& limits, Color us, int ply)
       maximumTime = std::min(t2, maximumTime);
   }
 
-  if (Options["Ponder"])
+  if (Opts.ponder)
       optimumTime += optimumTime / 4;
 }
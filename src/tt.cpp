@@ -18,30 +18,88 @@
   along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
 #include <cstring>   // For std::memset
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <thread>
+#include <vector>
+
+#ifdef TT_STATS
+#include <deque>
+#include <mutex>
+#endif
 
 #include "bitboard.h"
 #include "tt.h"
+#include "uci.h"
 
 TranspositionTable TT; // Our global transposition table
 
+const char TranspositionTable::HashFileMagic[8] = { 'S', 'F', 'H', 'A', 'S', 'H', '0', '1' };
+
+#ifdef TT_STATS
+
+namespace {
+
+  std::mutex statsMutex;
+  std::deque<TTStats::Slot> statsSlots; // Grows only, slots outlive their thread
+}
+
+TTStats::Slot* TTStats::local() {
+
+  static thread_local Slot* slot = nullptr;
+
+  if (!slot)
+  {
+      std::lock_guard<std::mutex> lk(statsMutex);
+      statsSlots.push_back(Slot());
+      slot = &statsSlots.back();
+  }
+  return slot;
+}
+
+TTStats::Slot TTStats::aggregate() {
+
+  Slot sum = Slot();
+  std::lock_guard<std::mutex> lk(statsMutex);
+
+  for (const Slot& s : statsSlots)
+  {
+      sum.probes         += s.probes;
+      sum.hits           += s.hits;
+      sum.saves          += s.saves;
+      sum.refreshes      += s.refreshes;
+      sum.kept           += s.kept;
+      sum.fills          += s.fills;
+      sum.evictOldGen    += s.evictOldGen;
+      sum.evictShallower += s.evictShallower;
+      sum.evictDeeper    += s.evictDeeper;
+  }
+  return sum;
+}
+#endif
+
 
 /// TranspositionTable::resize() sets the size of the transposition table,
 /// measured in megabytes. Transposition table consists of a power of 2 number
 /// of clusters and each cluster consists of ClusterSize number of TTEntry.
+/// When 'force' is set the table is reallocated even if the size is unchanged,
+/// used when the "Large Pages" option is toggled.
 
-void TranspositionTable::resize(size_t mbSize) {
+void TranspositionTable::resize(size_t mbSize, bool force) {
 
   size_t newClusterCount = size_t(1) << msb((mbSize * 1024 * 1024) / sizeof(Cluster));
 
-  if (newClusterCount == clusterCount)
+  if (newClusterCount == clusterCount && !force)
       return;
 
   clusterCount = newClusterCount;
 
-  free(mem);
-  mem = calloc(clusterCount * sizeof(Cluster) + CacheLineSize - 1, 1);
+  aligned_ttmem_free(mem);
+  mem = aligned_ttmem_alloc(clusterCount * sizeof(Cluster) + CacheLineSize - 1,
+                            Options["Large Pages"]);
 
   if (!mem)
   {
@@ -51,16 +109,48 @@ void TranspositionTable::resize(size_t mbSize) {
   }
 
   table = (Cluster*)((uintptr_t(mem) + CacheLineSize - 1) & ~(CacheLineSize - 1));
+
+  // On a multi-socket machine spread the table pages evenly over all NUMA
+  // nodes, so that on average a probe is local for every pinned thread. The
+  // policy must be set before clear() first-touches the pages: mbind() does
+  // not migrate pages that have already been faulted in.
+  if (Opts.numaPinning)
+      interleave_pages(table, clusterCount * sizeof(Cluster));
+
+  clear(); // The new memory is not zeroed by the allocator
 }
 
 
 /// TranspositionTable::clear() overwrites the entire transposition table
 /// with zeros. It is called whenever the table is resized, or when the
 /// user asks the program to clear the table (from the UCI interface).
+/// The work is split between as many threads as configured with the
+/// "Threads" option: a single core needs several seconds to zero a big
+/// table, and with "NUMA Pinning" the parallel first touch also spreads
+/// the freshly allocated pages over the nodes the searchers run on.
 
 void TranspositionTable::clear() {
 
-  std::memset(table, 0, clusterCount * sizeof(Cluster));
+  std::vector<std::thread> threads;
+  size_t threadCount = Opts.threads;
+
+  for (size_t idx = 0; idx < threadCount; ++idx)
+      threads.emplace_back([this, idx, threadCount]() {
+
+          if (Opts.numaPinning)
+              bind_this_thread(idx);
+
+          // Each thread will zero its part of the hash table
+          const size_t stride = clusterCount / threadCount,
+                       start  = stride * idx,
+                       len    = idx != threadCount - 1 ?
+                                stride : clusterCount - start;
+
+          std::memset(&table[start], 0, len * sizeof(Cluster));
+      });
+
+  for (std::thread& th : threads)
+      th.join();
 }
 
 
@@ -76,30 +166,111 @@ TTEntry* TranspositionTable::probe(const Key key, bool& found) const {
   TTEntry* const tte = first_entry(key);
   const uint16_t key16 = key >> 48;  // Use the high 16 bits as key inside the cluster
 
+#ifdef TT_STATS
+  ++TTStats::local()->probes;
+#endif
+
+  // A single pass over the cluster both looks for our key and keeps track
+  // of the entry to be replaced if the key turns out to be absent, instead
+  // of rescanning the cluster for a replacement victim on a miss. The
+  // replacement work is wasted when we return early, but a probe touches
+  // one cache line either way and the miss case is the common one.
+  TTEntry* replace = tte;
+
   for (int i = 0; i < ClusterSize; ++i)
+  {
       if (!tte[i].key16 || tte[i].key16 == key16)
       {
           if ((tte[i].genBound8 & 0xFC) != generation8 && tte[i].key16)
               tte[i].genBound8 = uint8_t(generation8 | tte[i].bound()); // Refresh
 
+#ifdef TT_STATS
+          TTStats::local()->hits += (bool)tte[i].key16;
+#endif
+
           return found = (bool)tte[i].key16, &tte[i];
       }
 
-  // Find an entry to be replaced according to the replacement strategy
-  TTEntry* replace = tte;
-  for (int i = 1; i < ClusterSize; ++i)
-      // Due to our packed storage format for generation and its cyclic
+      // Replace the entry with the lowest depth minus 8 times its relative
+      // age. Due to our packed storage format for generation and its cyclic
       // nature we add 259 (256 is the modulus plus 3 to keep the lowest
       // two bound bits from affecting the result) to calculate the entry
       // age correctly even after generation8 overflows into the next cycle.
-      if (  replace->depth8 - ((259 + generation8 - replace->genBound8) & 0xFC) * 2 * ONE_PLY
-          >   tte[i].depth8 - ((259 + generation8 -   tte[i].genBound8) & 0xFC) * 2 * ONE_PLY)
+      if (i && replace->depth8 - ((259 + generation8 - replace->genBound8) & 0xFC) * 2 * ONE_PLY
+             >  tte[i].depth8 - ((259 + generation8 -   tte[i].genBound8) & 0xFC) * 2 * ONE_PLY)
           replace = &tte[i];
+  }
 
   return found = false, replace;
 }
 
 
+/// TranspositionTable::save() serializes the table to a file, so that a hash
+/// warmed by a long analysis session survives an engine restart. The format
+/// is a small header with the cluster count and the current generation,
+/// followed by the raw cluster array: TTEntry has a stable 10-byte layout.
+
+bool TranspositionTable::save(const std::string& fname) const {
+
+  std::ofstream f(fname, std::ios::binary);
+
+  if (!f)
+      return false;
+
+  uint64_t count = clusterCount;
+  f.write(HashFileMagic, sizeof(HashFileMagic));
+  f.write((const char*)&count, sizeof(count));
+  f.write((const char*)&generation8, sizeof(generation8));
+  f.write((const char*)table, clusterCount * sizeof(Cluster));
+
+  return bool(f);
+}
+
+
+/// TranspositionTable::load() restores a table written by save(). The table
+/// is reallocated to the cluster count found in the file, overriding the
+/// current "Hash" size.
+
+bool TranspositionTable::load(const std::string& fname) {
+
+  std::ifstream f(fname, std::ios::binary);
+
+  if (!f)
+      return false;
+
+  char magic[sizeof(HashFileMagic)];
+  uint64_t count;
+
+  f.read(magic, sizeof(magic));
+  f.read((char*)&count, sizeof(count));
+  f.read((char*)&generation8, sizeof(generation8));
+
+  if (   !f
+      || memcmp(magic, HashFileMagic, sizeof(magic))
+      || count & (count - 1)) // Must be a power of 2
+      return false;
+
+  if (count != clusterCount)
+  {
+      clusterCount = count;
+      aligned_ttmem_free(mem);
+      mem = aligned_ttmem_alloc(clusterCount * sizeof(Cluster) + CacheLineSize - 1,
+                                Options["Large Pages"]);
+      if (!mem)
+      {
+          std::cerr << "Failed to allocate transposition table for hash file load." << std::endl;
+          exit(EXIT_FAILURE);
+      }
+
+      table = (Cluster*)((uintptr_t(mem) + CacheLineSize - 1) & ~(CacheLineSize - 1));
+  }
+
+  f.read((char*)table, clusterCount * sizeof(Cluster));
+
+  return bool(f);
+}
+
+
 /// Returns an approximation of the hashtable occupation during a search. The
 /// hash is x permill full, as per UCI protocol.
 
@@ -115,3 +286,64 @@ int TranspositionTable::hashfull() const
   }
   return cnt;
 }
+
+
+/// TranspositionTable::print_stats() implements the "ttstats" command: it
+/// prints a cluster occupancy histogram computed over a sample of the table
+/// and, when compiled with ttstats=yes, the aggregated per-thread probe and
+/// eviction counters. Used to size the hash rationally per time control.
+
+void TranspositionTable::print_stats() const {
+
+  const size_t sampled = std::min(clusterCount, size_t(10000));
+  size_t fill[ClusterSize + 1] = {};
+  uint64_t curGen = 0, oldGen = 0;
+
+  for (size_t i = 0; i < sampled; ++i)
+  {
+      int cnt = 0;
+      for (int j = 0; j < ClusterSize; ++j)
+      {
+          const TTEntry& tte = table[i].entry[j];
+
+          if (tte.key16 || tte.genBound8 || tte.depth8)
+          {
+              ++cnt;
+              ((tte.genBound8 & 0xFC) == generation8 ? ++curGen : ++oldGen);
+          }
+      }
+      ++fill[cnt];
+  }
+
+  auto pct = [](uint64_t a, uint64_t b) { return b ? 100.0 * a / b : 0.0; };
+
+  sync_cout << std::fixed << std::setprecision(1)
+            << "info string TT " << clusterCount * sizeof(Cluster) / (1024 * 1024)
+            << "MB, sampled " << sampled << " clusters: this gen "
+            << pct(curGen, ClusterSize * sampled) << "%, older gens "
+            << pct(oldGen, ClusterSize * sampled) << "%, empty "
+            << pct(ClusterSize * sampled - curGen - oldGen, ClusterSize * sampled) << '%';
+
+  uci_out() << "\ninfo string TT cluster fill";
+  for (int i = 0; i <= ClusterSize; ++i)
+      uci_out() << ' ' << i << '/' << ClusterSize << ": " << pct(fill[i], sampled) << '%';
+
+#ifdef TT_STATS
+  TTStats::Slot t = TTStats::aggregate();
+
+  uci_out() << "\ninfo string TT probes " << t.probes << ", hits " << t.hits
+            << " (" << pct(t.hits, t.probes) << "%)"
+            << "\ninfo string TT saves " << t.saves
+            << ": fill " << pct(t.fills, t.saves)
+            << "%, refresh " << pct(t.refreshes, t.saves)
+            << "%, keep " << pct(t.kept, t.saves)
+            << "%, evict old-gen " << pct(t.evictOldGen, t.saves)
+            << "%, shallower " << pct(t.evictShallower, t.saves)
+            << "%, deeper " << pct(t.evictDeeper, t.saves) << '%';
+#else
+  uci_out() << "\ninfo string TT probe and save counters not compiled in, "
+               "build with ttstats=yes";
+#endif
+
+  uci_out() << std::defaultfloat << sync_endl;
+}
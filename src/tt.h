@@ -24,6 +24,32 @@
 #include "misc.h"
 #include "types.h"
 
+#ifdef TT_STATS
+
+/// TTStats holds per-thread transposition table telemetry, compiled in with
+/// 'make build ... ttstats=yes'. Every thread counts into its own cache line
+/// sized slot, so the instrumented hot path needs no locks or atomics; the
+/// "ttstats" command aggregates the slots and prints them.
+
+struct TTStats {
+
+  struct alignas(64) Slot {
+    uint64_t probes;         // Calls to TT.probe()
+    uint64_t hits;           // ...that found the position
+    uint64_t saves;          // Calls to TTEntry::save()
+    uint64_t refreshes;      // ...that overwrote the same position
+    uint64_t kept;           // ...that preserved a more valuable entry
+    uint64_t fills;          // ...that filled an empty entry
+    uint64_t evictOldGen;    // ...that evicted an entry of a previous search
+    uint64_t evictShallower; // ...that evicted a shallower entry of this search
+    uint64_t evictDeeper;    // ...that evicted a deeper entry of this search
+  };
+
+  static Slot* local();     // This thread's slot, allocated on first use
+  static Slot aggregate();  // Sum over all slots ever allocated
+};
+#endif
+
 /// TTEntry struct is the 10 bytes transposition table entry, defined as below:
 ///
 /// key        16 bit
@@ -44,6 +70,20 @@ struct TTEntry {
 
   void save(Key k, Value v, Bound b, Depth d, Move m, Value ev, uint8_t g) {
 
+#ifdef TT_STATS
+    TTStats::Slot* stat = TTStats::local();
+    ++stat->saves;
+
+    if ((k >> 48) == key16)
+        ++(d > depth8 - 4 || b == BOUND_EXACT ? stat->refreshes : stat->kept);
+    else if (!key16 && !genBound8 && !depth8)
+        ++stat->fills;
+    else if ((genBound8 & 0xFC) != g)
+        ++stat->evictOldGen;
+    else
+        ++(d > depth8 ? stat->evictShallower : stat->evictDeeper);
+#endif
+
     // Preserve any existing move for the same position
     if (m || (k >> 48) != key16)
         move16 = (uint16_t)m;
@@ -93,14 +133,19 @@ class TranspositionTable {
 
   static_assert(CacheLineSize % sizeof(Cluster) == 0, "Cluster size incorrect");
 
+  static const char HashFileMagic[8]; // Identifies files written by save()
+
 public:
- ~TranspositionTable() { free(mem); }
+ ~TranspositionTable() { aligned_ttmem_free(mem); }
   void new_search() { generation8 += 4; } // Lower 2 bits are used by Bound
   uint8_t generation() const { return generation8; }
   TTEntry* probe(const Key key, bool& found) const;
   int hashfull() const;
-  void resize(size_t mbSize);
+  void print_stats() const;
+  void resize(size_t mbSize, bool force = false);
   void clear();
+  bool save(const std::string& fname) const;
+  bool load(const std::string& fname);
 
   // The lowest order bits of the key are used to get the index of the cluster
   TTEntry* first_entry(const Key key) const {
@@ -18,9 +18,14 @@
   along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <iostream>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
 
 #include "evaluate.h"
 #include "movegen.h"
@@ -28,17 +33,108 @@
 #include "search.h"
 #include "thread.h"
 #include "timeman.h"
+#include "tt.h"
 #include "uci.h"
+#include "syzygy/tbprobe.h"
 
 using namespace std;
 
 extern void benchmark(const Position& pos, istream& is);
+extern void analyze_file(istream& is);
+extern void pack_file(istream& is);
+extern void run_suite(istream& is);
+extern void run_sweep(istream& is);
 
 namespace {
 
   // FEN string of the initial position, normal chess
   const char* StartFEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
 
+
+  // InputReader runs a dedicated thread that drains stdin into a command
+  // queue, so the pipe is read promptly even while the loop thread is busy
+  // with a long command like "bench" or "suite". The latency-critical
+  // commands are acted on directly from the reader thread: "stop",
+  // "ponderhit" and "quit" just flip the search signals, and "isready" is
+  // answered immediately when no other command is pending or executing, so
+  // the GUI round-trip stays bounded regardless of the search state. An
+  // "isready" behind queued or still-running commands is answered in order,
+  // preserving the usual setoption/isready synchronization.
+
+  class InputReader {
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<string> commands;
+    std::thread reader;
+    std::atomic_bool executing{false}; // Dequeued command still being run
+
+    void read_loop() {
+
+      string cmd, token;
+      bool quit = false;
+
+      while (!quit)
+      {
+          if (!getline(cin, cmd)) // EOF means the GUI died, exit gracefully
+              cmd = "quit";
+
+          istringstream is(cmd);
+          token.clear();
+          is >> skipws >> token;
+
+          quit = token == "quit";
+
+          if (    quit
+              ||  token == "stop"
+              || (token == "ponderhit" && Search::Signals.stopOnPonderhit))
+          {
+              Search::Signals.stop = true;
+              Threads.main()->start_searching(true); // Could be sleeping
+          }
+          else if (token == "ponderhit")
+          {
+              Search::Limits.ponder = 0; // Switch to normal search
+              continue; // Fully handled here
+          }
+
+          std::unique_lock<std::mutex> lk(mutex);
+
+          // An empty queue alone is not enough: the loop thread may have
+          // dequeued a command (say a big "setoption name Hash") that is
+          // still running, and "isready" must not overtake it.
+          if (token == "isready" && commands.empty() && !executing)
+          {
+              lk.unlock();
+              sync_cout << "readyok" << sync_endl;
+              continue;
+          }
+
+          commands.push_back(cmd);
+          cv.notify_one();
+      }
+    }
+
+  public:
+    void start() { reader = std::thread(&InputReader::read_loop, this); }
+    void join() { reader.join(); }
+
+    string next() {
+
+      std::unique_lock<std::mutex> lk(mutex);
+      cv.wait(lk, [&]{ return !commands.empty(); });
+
+      string cmd = commands.front();
+      commands.pop_front();
+      executing = true; // Until the loop thread calls done()
+      return cmd;
+    }
+
+    void done() { executing = false; }
+  };
+
+  InputReader Input;
+
   // A list to keep track of the position states along the setup moves (from the
   // start position to the position just before the search starts). Needed by
   // 'draw by repetition' detection.
@@ -68,8 +164,8 @@ namespace {
     else
         return;
 
-    States = StateListPtr(new std::deque<StateInfo>(1));
-    pos.set(fen, Options["UCI_Chess960"], &States->back(), Threads.main());
+    States = Threads.fresh_states(); // Recycles the previous list if possible
+    pos.set(fen, Opts.chess960, &States->back(), Threads.main());
 
     // Parse move list (if any)
     while (is >> token && (m = UCI::to_move(pos, token)) != MOVE_NONE)
@@ -77,6 +173,10 @@ namespace {
         States->push_back(StateInfo());
         pos.do_move(m, States->back(), pos.gives_check(m, CheckInfo(pos)));
     }
+
+    // Warm up the tablebase files for this position in the background, so
+    // that a cold DTZ probe does not stall the search once "go" arrives.
+    Tablebases::warm_root_async(pos);
   }
 
 
@@ -154,9 +254,12 @@ void UCI::loop(int argc, char* argv[]) {
   for (int i = 1; i < argc; ++i)
       cmd += std::string(argv[i]) + " ";
 
+  if (argc == 1)
+      Input.start();
+
   do {
-      if (argc == 1 && !getline(cin, cmd)) // Block here waiting for input or EOF
-          cmd = "quit";
+      if (argc == 1)
+          cmd = Input.next(); // Block here waiting for a queued command
 
       istringstream is(cmd);
 
@@ -194,8 +297,25 @@ void UCI::loop(int argc, char* argv[]) {
       else if (token == "setoption")  setoption(is);
 
       // Additional custom non-UCI commands, useful for debugging
+      else if (token == "ttsave" || token == "ttload")
+      {
+          string fname;
+          is >> fname;
+
+          Threads.main()->wait_for_search_finished();
+
+          bool ok = token == "ttsave" ? TT.save(fname) : TT.load(fname);
+          sync_cout << "info string hash file " << (token == "ttsave" ? "save" : "load")
+                    << (ok ? " ok: " : " failed: ") << fname << sync_endl;
+      }
+      else if (token == "ttstats")    TT.print_stats();
+      else if (token == "searchstats") Search::print_stats();
       else if (token == "flip")       pos.flip();
       else if (token == "bench")      benchmark(pos, is);
+      else if (token == "analyzefile") analyze_file(is);
+      else if (token == "packfile")    pack_file(is);
+      else if (token == "suite")       run_suite(is);
+      else if (token == "sweep")       run_sweep(is);
       else if (token == "d")          sync_cout << pos << sync_endl;
       else if (token == "eval")       sync_cout << Eval::trace(pos) << sync_endl;
       else if (token == "perft")
@@ -212,8 +332,14 @@ void UCI::loop(int argc, char* argv[]) {
       else
           sync_cout << "Unknown command: " << cmd << sync_endl;
 
+      if (argc == 1)
+          Input.done(); // The command has fully executed
+
   } while (token != "quit" && argc == 1); // Passed args have one-shot behaviour
 
+  if (argc == 1)
+      Input.join();
+
   Threads.main()->wait_for_search_finished();
 }
 
@@ -65,16 +65,121 @@ private:
   OnChange on_change;
 };
 
+/// OptionSnapshot mirrors the engine-relevant spin and check options as plain
+/// ints and bools. Indexing the options map does a case-insensitive string
+/// compare per tree level plus a string-to-int conversion, too expensive for
+/// code that runs on every "position" and "go" command. The snapshot is
+/// refreshed on every option change, so hot paths just read a struct field.
+
+struct OptionSnapshot {
+  int    contempt;          // In centipawns, as typed by the user
+  int    skillLevel;
+  int    moveOverhead;
+  int    minThinkingTime;
+  int    slowMover;
+  int    npmsec;            // The "nodestime" option
+  int    syzygyProbeDepth;  // In plies, not yet scaled by ONE_PLY
+  int    syzygyProbeLimit;
+  int    pawnHashSize;      // In entries, not MB
+  int    materialHashSize;  // In entries, not MB
+  size_t threads;
+  size_t multiPV;
+  size_t clusterCount;
+  size_t clusterRank;
+  bool   ponder;
+  bool   chess960;
+  bool   numaPinning;
+  bool   syzygy50MoveRule;
+};
+
+/// LineBuffer appends the pieces of an "info" line - plain text, integers,
+/// moves and scores - into a fixed character buffer, so that the search can
+/// emit PV and currmove messages without touching the heap. Appends beyond
+/// the capacity are silently dropped.
+
+template<int Capacity>
+class LineBuffer {
+
+public:
+  LineBuffer() { clear(); }
+
+  void clear() { len = 0; buf[0] = '\0'; }
+  bool empty() const { return !len; }
+  const char* c_str() const { return buf; }
+
+  LineBuffer& add(const char* s) {
+
+    while (*s && len < Capacity - 1)
+        buf[len++] = *s++;
+
+    buf[len] = '\0';
+    return *this;
+  }
+
+  LineBuffer& add(int64_t n) {
+
+    if (n < 0)
+        add("-"), n = -n;
+
+    char digits[24];
+    int cnt = 0;
+
+    do
+        digits[cnt++] = char('0' + n % 10);
+    while (n /= 10);
+
+    while (cnt && len < Capacity - 1)
+        buf[len++] = digits[--cnt];
+
+    buf[len] = '\0';
+    return *this;
+  }
+
+  LineBuffer& add(Move m, bool chess960) {
+
+    if (m == MOVE_NONE)
+        return add("(none)");
+
+    if (m == MOVE_NULL)
+        return add("0000");
+
+    Square from = from_sq(m), to = to_sq(m);
+
+    if (type_of(m) == CASTLING && !chess960)
+        to = make_square(to > from ? FILE_G : FILE_C, rank_of(from));
+
+    char s[6] = { char('a' + file_of(from)), char('1' + rank_of(from)),
+                  char('a' + file_of(to)),   char('1' + rank_of(to)), '\0', '\0' };
+
+    if (type_of(m) == PROMOTION)
+        s[4] = " pnbrqk"[promotion_type(m)];
+
+    return add(s);
+  }
+
+  LineBuffer& add(Value v) {
+    return v > -(VALUE_MATE - MAX_PLY) && v < VALUE_MATE - MAX_PLY
+          ? add("cp ").add(int64_t(v * 100 / PawnValueEg))
+          : add("mate ").add(int64_t((v > 0 ? VALUE_MATE - v + 1 : -VALUE_MATE - v) / 2));
+  }
+
+private:
+  int len;
+  char buf[Capacity];
+};
+
 void init(OptionsMap&);
+void refresh_snapshot();
 void loop(int argc, char* argv[]);
 std::string value(Value v);
 std::string square(Square s);
 std::string move(Move m, bool chess960);
-std::string pv(const Position& pos, Depth depth, Value alpha, Value beta);
+const char* pv(const Position& pos, Depth depth, Value alpha, Value beta);
 Move to_move(const Position& pos, std::string& str);
 
 } // namespace UCI
 
 extern UCI::OptionsMap Options;
+extern UCI::OptionSnapshot Opts;
 
 #endif // #ifndef UCI_H_INCLUDED
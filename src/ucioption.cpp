@@ -31,16 +31,38 @@
 
 using std::string;
 
-UCI::OptionsMap Options; // Global object
+UCI::OptionsMap Options;      // Global object
+UCI::OptionSnapshot Opts;     // Plain-struct mirror of the options above
 
 namespace UCI {
 
 /// 'On change' actions, triggered by an option's value change
 void on_clear_hash(const Option&) { Search::clear(); }
 void on_hash_size(const Option& o) { TT.resize(o); }
+void on_large_pages(const Option&) { TT.resize(Options["Hash"], true); }
 void on_logger(const Option& o) { start_logger(o); }
 void on_threads(const Option&) { Threads.read_uci_options(); }
-void on_tb_path(const Option& o) { Tablebases::init(o); }
+void on_tb_path(const Option& o) {
+
+  // A speculative probe launched by a previous "position" command may still
+  // be reading the tables init() is about to free
+  Tablebases::warm_root_wait();
+
+  Tablebases::init(o);
+
+  // Cached WDL results may refer to tables that are no longer loaded
+  for (Thread* th : Threads)
+      th->wdlCache.clear();
+}
+
+void on_eval_hashes(const Option&) {
+
+  for (Thread* th : Threads)
+  {
+      th->pawnsTable.resize(Opts.pawnHashSize);
+      th->materialTable.resize(Opts.materialHashSize);
+  }
+}
 
 
 /// Our case insensitive less() function as required by UCI protocol
@@ -60,9 +82,15 @@ void init(OptionsMap& o) {
   o["Debug Log File"]        << Option("", on_logger);
   o["Contempt"]              << Option(0, -100, 100);
   o["Threads"]               << Option(1, 1, 128, on_threads);
+  o["NUMA Pinning"]          << Option(false, on_threads);
   o["Hash"]                  << Option(16, 1, MaxHashMB, on_hash_size);
+  o["Pawn Hash"]             << Option(16384, 1024, 1 << 24, on_eval_hashes);
+  o["Material Hash"]         << Option(8192, 1024, 1 << 24, on_eval_hashes);
+  o["Large Pages"]           << Option(true, on_large_pages);
   o["Clear Hash"]            << Option(on_clear_hash);
   o["Ponder"]                << Option(false);
+  o["Cluster Count"]         << Option(1, 1, 512);
+  o["Cluster Rank"]          << Option(0, 0, 511);
   o["MultiPV"]               << Option(1, 1, 500);
   o["Skill Level"]           << Option(20, 0, 20);
   o["Move Overhead"]         << Option(30, 0, 5000);
@@ -74,6 +102,36 @@ void init(OptionsMap& o) {
   o["SyzygyProbeDepth"]      << Option(1, 1, 100);
   o["Syzygy50MoveRule"]      << Option(true);
   o["SyzygyProbeLimit"]      << Option(6, 0, 6);
+
+  refresh_snapshot();
+}
+
+
+/// refresh_snapshot() re-reads the engine-relevant options into the Opts
+/// struct. Called once at startup and then from every option assignment,
+/// before the 'on change' action so that the actions already see the new
+/// values through Opts.
+
+void refresh_snapshot() {
+
+  Opts.contempt         = Options["Contempt"];
+  Opts.skillLevel       = Options["Skill Level"];
+  Opts.moveOverhead     = Options["Move Overhead"];
+  Opts.minThinkingTime  = Options["Minimum Thinking Time"];
+  Opts.slowMover        = Options["Slow Mover"];
+  Opts.npmsec           = Options["nodestime"];
+  Opts.syzygyProbeDepth = Options["SyzygyProbeDepth"];
+  Opts.pawnHashSize     = Options["Pawn Hash"];
+  Opts.materialHashSize = Options["Material Hash"];
+  Opts.syzygyProbeLimit = Options["SyzygyProbeLimit"];
+  Opts.threads          = Options["Threads"];
+  Opts.multiPV          = Options["MultiPV"];
+  Opts.clusterCount     = Options["Cluster Count"];
+  Opts.clusterRank      = Options["Cluster Rank"];
+  Opts.ponder           = Options["Ponder"];
+  Opts.chess960         = Options["UCI_Chess960"];
+  Opts.numaPinning      = Options["NUMA Pinning"];
+  Opts.syzygy50MoveRule = Options["Syzygy50MoveRule"];
 }
 
 
@@ -154,6 +212,8 @@ Option& Option::operator=(const string& v) {
   if (type != "button")
       currentValue = v;
 
+  refresh_snapshot();
+
   if (on_change)
       on_change(*this);
 